@@ -0,0 +1,209 @@
+﻿#include "AoiGrid.h"
+
+AOI_Grid::AOI_Grid()
+{
+	worldSize = 0;
+	cellSize = 1;
+	viewRange = 1;
+	cellCnt = 0;
+	entityCnt = 0;
+	moveCnt = 0;
+	cellChangeCnt = 0;
+	queryCnt = 0;
+	queryResultCnt = 0;
+}
+
+AOI_Grid::~AOI_Grid()
+{
+}
+
+bool AOI_Grid::init_grid(const int worldSize, const int cellSize, const int viewRange, const int maxEntity)
+{
+	if (worldSize <= 0 || cellSize <= 0 || maxEntity <= 0) {
+		spdlog::error("[AOI] worldSize({}) cellSize({}) maxEntity({}) is invalid", worldSize, cellSize, maxEntity);
+		return false;
+	}
+	this->worldSize = worldSize;
+	this->cellSize = cellSize;
+	this->viewRange = viewRange < 0 ? 0 : viewRange;
+	cellCnt = (worldSize + cellSize - 1) / cellSize;
+
+	AOI_Entity empty;
+	empty.handle = INVALID_SESSION_HANDLE;
+	empty.cell = AOI_NOT_ENTERED;
+	empty.cellPos = 0;
+	entities.assign(maxEntity, empty);
+	cells.assign((size_t)cellCnt * cellCnt, std::vector<int>());
+	return true;
+}
+
+bool AOI_Grid::update(const int slot, const session_handle handle, const Location& pos)
+{
+	// Packet 처리 중에 종료된 세션이 leave 이후 다시 들어오면 지워지지 않는 entity 가 남는다.
+	auto pPlayerSession = epoll_server.getSessionByHandle(handle);
+	if (pPlayerSession == nullptr) return false;
+	std::lock_guard<std::mutex> sendGuard(pPlayerSession->send_mutex());
+	if (pPlayerSession->get_handle() != handle) return false;
+	return move_entity(slot, handle, pos);
+}
+
+bool AOI_Grid::move_entity(const int slot, const session_handle handle, const Location& pos)
+{
+	if (slot < 0 || slot >= (int)entities.size()) return false;
+	int cell = get_cell(pos);
+
+	std::lock_guard<std::mutex> guard(mLock);
+	moveCnt++;
+	AOI_Entity& entity = entities[slot];
+	if (entity.cell == cell) {
+		// 같은 cell 안의 이동은 목록을 고치지 않는다.
+		entity.handle = handle;
+		return false;
+	}
+	if (entity.cell != AOI_NOT_ENTERED) {
+		remove_from_cell(slot);
+	}
+	else {
+		entityCnt++;
+	}
+	entity.handle = handle;
+	entity.cell = cell;
+	entity.cellPos = (int)cells[cell].size();
+	cells[cell].emplace_back(slot);
+	cellChangeCnt++;
+	return true;
+}
+
+void AOI_Grid::leave(const int slot)
+{
+	if (slot < 0 || slot >= (int)entities.size()) return;
+	std::lock_guard<std::mutex> guard(mLock);
+	if (entities[slot].cell == AOI_NOT_ENTERED) return;
+	remove_from_cell(slot);
+	entities[slot].cell = AOI_NOT_ENTERED;
+	entities[slot].handle = INVALID_SESSION_HANDLE;
+	entityCnt--;
+}
+
+int AOI_Grid::query(const Location& pos, const int excludeSlot, std::vector<session_handle>& out)
+{
+	out.clear();
+	int cell = get_cell(pos);
+	int cellX = cell % cellCnt;
+	int cellY = cell / cellCnt;
+	int minX = std::max(cellX - viewRange, 0);
+	int maxX = std::min(cellX + viewRange, cellCnt - 1);
+	int minY = std::max(cellY - viewRange, 0);
+	int maxY = std::min(cellY + viewRange, cellCnt - 1);
+
+	std::lock_guard<std::mutex> guard(mLock);
+	for (int y = minY; y <= maxY; y++) {
+		for (int x = minX; x <= maxX; x++) {
+			for (int slot : cells[y * cellCnt + x]) {
+				if (slot == excludeSlot) continue;
+				out.emplace_back(entities[slot].handle);
+			}
+		}
+	}
+	queryCnt++;
+	queryResultCnt += out.size();
+	return (int)out.size();
+}
+
+Location AOI_Grid::clamp(const Location& pos)
+{
+	Location result;
+	result.x = std::min(std::max(pos.x, 0), worldSize - 1);
+	result.y = std::min(std::max(pos.y, 0), worldSize - 1);
+	return result;
+}
+
+Location AOI_Grid::spawn_position(const unsigned_int64 uniqueNo)
+{
+	// 같은 uniqueNo 는 항상 같은 위치 에서 시작한다.
+	unsigned_int64 hash = (uniqueNo + 1) * 0x9E3779B97F4A7C15ULL;
+	Location pos;
+	pos.x = (int)((hash >> 16) % (unsigned_int64)worldSize);
+	pos.y = (int)((hash >> 40) % (unsigned_int64)worldSize);
+	return pos;
+}
+
+bool AOI_Grid::is_entered(const int slot)
+{
+	if (slot < 0 || slot >= (int)entities.size()) return false;
+	std::lock_guard<std::mutex> guard(mLock);
+	return entities[slot].cell != AOI_NOT_ENTERED;
+}
+
+void AOI_Grid::logStats()
+{
+	std::lock_guard<std::mutex> guard(mLock);
+	spdlog::info("[AOI] world : {}, cell : {} ({} x {}), view : {}, entities : {}, moves : {}, cell changes : {}, queries : {}, avg result : {:.1f}",
+		worldSize, cellSize, cellCnt, cellCnt, viewRange, entityCnt, moveCnt, cellChangeCnt, queryCnt,
+		queryCnt > 0 ? (double)queryResultCnt / queryCnt : 0.0);
+}
+
+void AOI_Grid::benchmark(const int entityCnt)
+{
+	// 서버 격자와 별도로 현재 설정 (월드, cell, 시야) 으로 측정한다.
+	AOI_Grid *pGrid = new AOI_Grid;
+	if (!pGrid->init_grid(CS.get_aoi_world_size(), CS.get_aoi_cell_size(), CS.get_aoi_view_range(), entityCnt)) {
+		delete pGrid;
+		return;
+	}
+	std::vector<Location> positions(entityCnt);
+	for (int i = 0; i < entityCnt; i++) {
+		positions[i] = pGrid->spawn_position(i);
+		pGrid->move_entity(i, MAKE_SESSION_HANDLE(1, i), positions[i]);
+	}
+
+	// 이동 : 한번에 cell 크기의 1/4 이내 로 움직인다.
+	unsigned int seed = 2463534242u;
+	int step = std::max(pGrid->cellSize / 4, 1);
+	auto begin = std::chrono::steady_clock::now();
+	for (int round = 0; round < AOI_BENCH_ROUND; round++) {
+		for (int i = 0; i < entityCnt; i++) {
+			seed ^= seed << 13; seed ^= seed >> 17; seed ^= seed << 5;
+			positions[i].x += (int)(seed % (2 * step + 1)) - step;
+			positions[i].y += (int)((seed >> 16) % (2 * step + 1)) - step;
+			positions[i] = pGrid->clamp(positions[i]);
+			pGrid->move_entity(i, MAKE_SESSION_HANDLE(1, i), positions[i]);
+		}
+	}
+	auto moved = std::chrono::steady_clock::now();
+
+	// 조회 : entity 마다 주변 세션
+	std::vector<session_handle> targets;
+	unsigned_int64 resultCnt = 0;
+	for (int round = 0; round < AOI_BENCH_ROUND; round++) {
+		for (int i = 0; i < entityCnt; i++) {
+			resultCnt += pGrid->query(positions[i], i, targets);
+		}
+	}
+	auto queried = std::chrono::steady_clock::now();
+
+	unsigned_int64 opCnt = (unsigned_int64)entityCnt * AOI_BENCH_ROUND;
+	double moveSec = std::chrono::duration<double>(moved - begin).count();
+	double querySec = std::chrono::duration<double>(queried - moved).count();
+	spdlog::info("[AOI Bench] entities : {}, updates/sec : {:.0f} (cell changes : {}), queries/sec : {:.0f}, avg result : {:.1f}",
+		entityCnt, moveSec > 0 ? opCnt / moveSec : 0.0, pGrid->cellChangeCnt - entityCnt,
+		querySec > 0 ? opCnt / querySec : 0.0, (double)resultCnt / opCnt);
+	delete pGrid;
+}
+
+int AOI_Grid::get_cell(const Location& pos)
+{
+	Location clamped = clamp(pos);
+	return (clamped.y / cellSize) * cellCnt + (clamped.x / cellSize);
+}
+
+void AOI_Grid::remove_from_cell(const int slot)
+{
+	// 마지막 slot 을 빈 자리로 옮긴다. (순서 유지 안함)
+	AOI_Entity& entity = entities[slot];
+	std::vector<int>& cellSlots = cells[entity.cell];
+	int lastSlot = cellSlots.back();
+	cellSlots[entity.cellPos] = lastSlot;
+	entities[lastSlot].cellPos = entity.cellPos;
+	cellSlots.pop_back();
+}
@@ -0,0 +1,53 @@
+﻿#ifndef __AOI_GRID_H__
+#define __AOI_GRID_H__
+
+#include "Main.h"
+
+#include <mutex>
+
+#define AOI_NOT_ENTERED -1			// 격자에 없는 entity 의 cell
+#define AOI_BENCH_ROUND 10			// benchmark 이동 / 조회 반복 수
+
+// 균일 격자 관심 영역 (Area Of Interest)
+// entity 는 세션 slot 으로 찾고, cell 마다 slot 목록을 가진다.
+// 이동은 cell 이 바뀔 때만 목록을 고치고 (swap remove O(1)), 조회는 주변 (2 * VIEW_RANGE + 1)^2 cell 만 본다.
+// Logic_API (이동, 조회) 와 I/O Thread (종료) 가 같이 사용하므로 lock 을 잡는다.
+// 이동은 세션 send_mutex 안에서 handle 을 확인하여 ClosePlayer 의 leave 이후 다시 등록 되지 않게 한다. (lock 순서 : send_mutex -> mLock)
+class AOI_Grid {
+public:
+	AOI_Grid();
+	~AOI_Grid();
+	bool init_grid(const int worldSize, const int cellSize, const int viewRange, const int maxEntity);
+	bool update(const int slot, const session_handle handle, const Location& pos);	// 처음이면 등록, cell 이 바뀌면 true (종료된 handle 은 무시)
+	void leave(const int slot);														// 격자 에서 제거
+	int query(const Location& pos, const int excludeSlot, std::vector<session_handle>& out);	// 주변 cell 세션 (excludeSlot 제외)
+	Location clamp(const Location& pos);											// 월드 범위로 자른다.
+	Location spawn_position(const unsigned_int64 uniqueNo);							// uniqueNo 로 흩어진 시작 위치
+	bool is_entered(const int slot);
+	void logStats();
+	static void benchmark(const int entityCnt);										// 이동 / 조회 처리량 측정
+
+private:
+	struct AOI_Entity {
+		session_handle handle;
+		int cell;									// 현재 cell (AOI_NOT_ENTERED : 없음)
+		int cellPos;								// cells[cell] 안의 위치
+	};
+	int worldSize;
+	int cellSize;
+	int viewRange;									// 주변 몇 칸 까지 보는가
+	int cellCnt;									// 한 축의 cell 수
+	std::vector<AOI_Entity> entities;				// slot 별 entity
+	std::vector<std::vector<int>> cells;			// cell 별 slot 목록
+	int entityCnt;
+	unsigned_int64 moveCnt;							// update 수
+	unsigned_int64 cellChangeCnt;					// cell 이 바뀐 update 수
+	unsigned_int64 queryCnt;						// query 수
+	unsigned_int64 queryResultCnt;					// query 결과 세션 수 (누적)
+	std::mutex mLock;
+	int get_cell(const Location& pos);
+	bool move_entity(const int slot, const session_handle handle, const Location& pos);	// 격자 이동 (handle 확인 없음)
+	void remove_from_cell(const int slot);
+};
+
+#endif
@@ -0,0 +1,319 @@
+﻿#include "BufferPool.h"
+
+#include <chrono>
+#include <sys/mman.h>
+
+Buffer_Pool::~Buffer_Pool()
+{
+	for (auto& sizeClass : classes) {
+		for (auto pBlock : sizeClass.freeBlocks) {
+			free_block(pBlock);
+		}
+		sizeClass.freeBlocks.clear();
+	}
+	for (int i = 0; i < POOL_CLASS_CNT; i++) {
+		for (auto pBase : classes[i].freeMirrors) {
+			free_mirror(pBase, POOL_MIN_CLASS << i);
+		}
+		for (auto pBase : classes[i].idleMirrors) {
+			free_mirror(pBase, POOL_MIN_CLASS << i);
+		}
+		classes[i].freeMirrors.clear();
+		classes[i].idleMirrors.clear();
+	}
+	if (arenaBase != nullptr) {
+		munmap(arenaBase, arenaSize);
+		arenaBase = nullptr;
+	}
+}
+
+void Buffer_Pool::init(const int arenaMB, const bool hugePage)
+{
+	if (arenaMB <= 0 || arenaBase != nullptr) {
+		return;
+	}
+	size_t size = (size_t)arenaMB * 1024 * 1024;
+	void* pArena = MAP_FAILED;
+	if (hugePage) {
+		// 예약된 hugepage (vm.nr_hugepages) 가 없으면 실패 한다.
+		pArena = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		arenaHuge = pArena != MAP_FAILED;
+	}
+	if (pArena == MAP_FAILED) {
+		pArena = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (pArena == MAP_FAILED) {
+			spdlog::error("[BufferPool] arena mmap failure ({} MB) : {}", arenaMB, strerror(errno));
+			return;
+		}
+		// Transparent Huge Page 요청 (madvise 모드에서만 의미가 있다)
+		if (hugePage) {
+			madvise(pArena, size, MADV_HUGEPAGE);
+		}
+	}
+	arenaBase = (char*)pArena;
+	arenaSize = size;
+	spdlog::info("[BufferPool] arena : {} MB, page : {}", arenaMB, arenaHuge ? "hugetlb" : (hugePage ? "thp (madvise)" : "normal"));
+}
+
+int Buffer_Pool::get_class_no(const int size)
+{
+	int classNo = 0;
+	while (classNo < POOL_CLASS_CNT && (POOL_MIN_CLASS << classNo) < size) {
+		classNo++;
+	}
+	return classNo;
+}
+
+int Buffer_Pool::get_idle_mirror_max()
+{
+	// mirror 하나는 map 2개를 사용한다. (읽지 못하면 커널 기본 값)
+	long long maxMapCount = 65530;
+	FILE* pFile = fopen("/proc/sys/vm/max_map_count", "r");
+	if (pFile != nullptr) {
+		if (fscanf(pFile, "%lld", &maxMapCount) != 1) {
+			maxMapCount = 65530;
+		}
+		fclose(pFile);
+	}
+	return (int)(maxMapCount / POOL_IDLE_MAP_SHARE / 2 / POOL_CLASS_CNT);
+}
+
+int Buffer_Pool::get_class_size(const int size)
+{
+	int classNo = get_class_no(size);
+	return classNo < POOL_CLASS_CNT ? POOL_MIN_CLASS << classNo : size;
+}
+
+char * Buffer_Pool::alloc_arena(const int classSize)
+{
+	if (arenaBase == nullptr) {
+		return nullptr;
+	}
+	size_t offset = arenaUsed.fetch_add(classSize, std::memory_order_relaxed);
+	if (offset + classSize > arenaSize) {
+		// arena 를 모두 사용했다. (이후는 new)
+		arenaUsed.fetch_sub(classSize, std::memory_order_relaxed);
+		return nullptr;
+	}
+	return arenaBase + offset;
+}
+
+char * Buffer_Pool::alloc(const int size)
+{
+	int classNo = get_class_no(size);
+	if (classNo >= POOL_CLASS_CNT) {
+		// Pool 크기 보다 크면 보관하지 않는다.
+		return new char[size];
+	}
+	auto& sizeClass = classes[classNo];
+	sizeClass.inUse.fetch_add(1, std::memory_order_relaxed);
+	{
+		std::lock_guard<std::mutex> guard(sizeClass.mLock);
+		if (!sizeClass.freeBlocks.empty()) {
+			char* pBlock = sizeClass.freeBlocks.back();
+			sizeClass.freeBlocks.pop_back();
+			return pBlock;
+		}
+	}
+	sizeClass.created.fetch_add(1, std::memory_order_relaxed);
+	char* pBlock = alloc_arena(POOL_MIN_CLASS << classNo);
+	return pBlock != nullptr ? pBlock : new char[POOL_MIN_CLASS << classNo];
+}
+
+void Buffer_Pool::release(char * pBlock, const int size)
+{
+	if (pBlock == nullptr) return;
+	int classNo = get_class_no(size);
+	if (classNo >= POOL_CLASS_CNT) {
+		delete[] pBlock;
+		return;
+	}
+	auto& sizeClass = classes[classNo];
+	sizeClass.inUse.fetch_sub(1, std::memory_order_relaxed);
+	{
+		std::lock_guard<std::mutex> guard(sizeClass.mLock);
+		// arena block 은 개별 해제 할 수 없으므로 항상 보관한다.
+		if (in_arena(pBlock) || (int)sizeClass.freeBlocks.size() < POOL_MAX_FREE_BYTES / (POOL_MIN_CLASS << classNo)) {
+			sizeClass.freeBlocks.emplace_back(pBlock);
+			return;
+		}
+	}
+	sizeClass.created.fetch_sub(1, std::memory_order_relaxed);
+	free_block(pBlock);
+}
+
+void Buffer_Pool::free_block(char * pBlock)
+{
+	if (!in_arena(pBlock)) {
+		delete[] pBlock;
+	}
+}
+
+char * Buffer_Pool::alloc_mirror(const int size)
+{
+	int classNo = get_class_no(size);
+	if (classNo >= POOL_CLASS_CNT || (POOL_MIN_CLASS << classNo) != size) {
+		// 크기 별 Pool 에 맞지 않는 크기는 매번 만든다.
+		return create_mirror(size);
+	}
+	auto& sizeClass = classes[classNo];
+	{
+		std::lock_guard<std::mutex> guard(sizeClass.mLock);
+		// page 가 남아 있는 mirror 를 먼저 사용한다.
+		auto& freeList = !sizeClass.freeMirrors.empty() ? sizeClass.freeMirrors : sizeClass.idleMirrors;
+		if (!freeList.empty()) {
+			char* pBase = freeList.back();
+			freeList.pop_back();
+			sizeClass.mirrorInUse.fetch_add(1, std::memory_order_relaxed);
+			return pBase;
+		}
+	}
+	char* pBase = create_mirror(size);
+	if (pBase != nullptr) {
+		sizeClass.mirrorInUse.fetch_add(1, std::memory_order_relaxed);
+		sizeClass.mirrorCreated.fetch_add(1, std::memory_order_relaxed);
+	}
+	return pBase;
+}
+
+void Buffer_Pool::release_mirror(char * pBase, const int size)
+{
+	if (pBase == nullptr) return;
+	int classNo = get_class_no(size);
+	if (classNo >= POOL_CLASS_CNT || (POOL_MIN_CLASS << classNo) != size) {
+		free_mirror(pBase, size);
+		return;
+	}
+	auto& sizeClass = classes[classNo];
+	sizeClass.mirrorInUse.fetch_sub(1, std::memory_order_relaxed);
+	bool keepMap;
+	{
+		std::lock_guard<std::mutex> guard(sizeClass.mLock);
+		if ((int)sizeClass.freeMirrors.size() < POOL_MAX_FREE_BYTES / size) {
+			sizeClass.freeMirrors.emplace_back(pBase);
+			return;
+		}
+		keepMap = (int)sizeClass.idleMirrors.size() < idleMirrorMax;
+	}
+	if (keepMap) {
+		// 보관 크기를 넘으면 map 은 두고 memfd page 만 해제한다. (다시 만드는 비용 memfd + mmap 3번을 피한다)
+		madvise(pBase, size, MADV_REMOVE);
+		std::lock_guard<std::mutex> guard(sizeClass.mLock);
+		sizeClass.idleMirrors.emplace_back(pBase);
+		return;
+	}
+	// map 수 한도를 넘으면 (접속 급증 이후) vm.max_map_count 를 다 쓰지 않도록 unmap 한다.
+	sizeClass.mirrorCreated.fetch_sub(1, std::memory_order_relaxed);
+	free_mirror(pBase, size);
+}
+
+char * Buffer_Pool::create_mirror(const int size)
+{
+	// 같은 memfd 를 연속된 주소에 두번 map 한다. (buffer[i] == buffer[i + size])
+	int fd = memfd_create("ReadBuffer", MFD_CLOEXEC);
+	if (fd < 0) {
+		return nullptr;
+	}
+	if (ftruncate(fd, size) < 0) {
+		close(fd);
+		return nullptr;
+	}
+
+	// 2배 주소 공간을 예약한 뒤 같은 memfd 를 앞, 뒤에 덮어서 map 한다.
+	char* base = (char*)mmap(nullptr, (size_t)size * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (base == MAP_FAILED) {
+		close(fd);
+		return nullptr;
+	}
+	if (mmap(base, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED
+		|| mmap(base + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+		munmap(base, (size_t)size * 2);
+		close(fd);
+		return nullptr;
+	}
+	// map 이 memfd 를 참조하므로 fd 는 닫아도 된다.
+	close(fd);
+	return base;
+}
+
+void Buffer_Pool::free_mirror(char * pBase, const int size)
+{
+	munmap(pBase, (size_t)size * 2);
+}
+
+void Buffer_Pool::logStats()
+{
+	for (int i = 0; i < POOL_CLASS_CNT; i++) {
+		auto& sizeClass = classes[i];
+		int freeCnt, mirrorFreeCnt, mirrorIdleCnt;
+		{
+			std::lock_guard<std::mutex> guard(sizeClass.mLock);
+			freeCnt = (int)sizeClass.freeBlocks.size();
+			mirrorFreeCnt = (int)sizeClass.freeMirrors.size();
+			mirrorIdleCnt = (int)sizeClass.idleMirrors.size();
+		}
+		int created = sizeClass.created.load(std::memory_order_relaxed);
+		int mirrorCreated = sizeClass.mirrorCreated.load(std::memory_order_relaxed);
+		if (created == 0 && mirrorCreated == 0) continue;
+		spdlog::info("[BufferPool] class {} KB, linear (in use : {}, free : {}, created : {}), mirror (in use : {}, free : {}, page released : {} / {}, created : {})",
+			(POOL_MIN_CLASS << i) / 1024, sizeClass.inUse.load(std::memory_order_relaxed), freeCnt, created,
+			sizeClass.mirrorInUse.load(std::memory_order_relaxed), mirrorFreeCnt, mirrorIdleCnt, idleMirrorMax, mirrorCreated);
+	}
+	if (arenaBase != nullptr) {
+		spdlog::info("[BufferPool] arena used : {} / {} KB ({})", arenaUsed.load(std::memory_order_relaxed) / 1024, arenaSize / 1024,
+			arenaHuge ? "hugetlb" : "normal / thp");
+	}
+}
+
+void Buffer_Pool::benchmark(const int loopCnt)
+{
+	// 수신 한번 마다 Buffer 를 빌리고 돌려주는 비용 (EPOLLIN -> EAGAIN)
+	Buffer_Pool pool;
+	auto elapsedNs = [loopCnt](std::chrono::steady_clock::time_point begin) {
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / loopCnt;
+	};
+	volatile char sink = 0;
+
+	auto begin = std::chrono::steady_clock::now();
+	for (int i = 0; i < loopCnt; i++) {
+		char* pBlock = pool.alloc(MAX_SOCKBUF);
+		pBlock[0] = (char)i;
+		sink = sink + pBlock[0];
+		pool.release(pBlock, MAX_SOCKBUF);
+	}
+	double poolNs = elapsedNs(begin);
+
+	begin = std::chrono::steady_clock::now();
+	for (int i = 0; i < loopCnt; i++) {
+		char* pBlock = new char[MAX_SOCKBUF];
+		pBlock[0] = (char)i;
+		sink = sink + pBlock[0];
+		delete[] pBlock;
+	}
+	double newNs = elapsedNs(begin);
+
+	begin = std::chrono::steady_clock::now();
+	for (int i = 0; i < loopCnt; i++) {
+		char* pBase = pool.alloc_mirror(MAX_SOCKBUF);
+		if (pBase == nullptr) break;
+		pBase[0] = (char)i;
+		sink = sink + pBase[0];
+		pool.release_mirror(pBase, MAX_SOCKBUF);
+	}
+	double mirrorPoolNs = elapsedNs(begin);
+
+	// Pool 이 없으면 mirror 는 빌릴 때 마다 memfd + mmap 3번
+	const int createCnt = std::max(1, loopCnt / 100);
+	begin = std::chrono::steady_clock::now();
+	for (int i = 0; i < createCnt; i++) {
+		char* pBase = pool.create_mirror(MAX_SOCKBUF);
+		if (pBase == nullptr) break;
+		pBase[0] = (char)i;
+		sink = sink + pBase[0];
+		pool.free_mirror(pBase, MAX_SOCKBUF);
+	}
+	double mirrorCreateNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / createCnt;
+
+	spdlog::info("[BufferPool Bench] {} byte x {} : pool {:.1f} ns, new/delete {:.1f} ns, mirror pool {:.1f} ns, mirror create {:.1f} ns",
+		MAX_SOCKBUF, loopCnt, poolNs, newNs, mirrorPoolNs, mirrorCreateNs);
+}
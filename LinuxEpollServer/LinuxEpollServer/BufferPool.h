@@ -0,0 +1,56 @@
+﻿#ifndef __BUFFERPOOL_H__
+#define __BUFFERPOOL_H__
+
+#include "Main.h"
+
+#include <atomic>
+#include <mutex>
+
+#define POOL_MIN_CLASS 4096							// 가장 작은 크기 (4K, 8K, 16K, 32K, 64K)
+#define POOL_CLASS_CNT 5
+#define POOL_MAX_FREE_BYTES (16 * 1024 * 1024)		// 크기 별로 보관하는 최대 byte (넘으면 해제, arena 는 보관, mirror 는 page 만 해제)
+#define POOL_IDLE_MAP_SHARE 4						// page 를 해제한 mirror 가 쓸 수 있는 map 수 (vm.max_map_count 의 1/4, 나머지는 사용중 세션)
+
+// 크기 별 Buffer Pool (모든 세션, Thread 가 같이 사용)
+// 세션은 받은 데이터가 남아 있는 동안만 Buffer 를 빌리고, 다 읽으면 돌려준다. (유휴 세션은 Buffer 가 없다)
+// linear : 일반 block (arena 를 사용하면 arena 에서 잘라서 준다)
+// mirror : memfd 두번 map 한 영역 (map 생성 비용이 크므로 보관 크기를 넘으면 page 만 해제하고, map 수 한도를 넘으면 unmap 한다)
+class Buffer_Pool {
+public:
+	~Buffer_Pool();
+	void init(const int arenaMB, const bool hugePage);		// arena 준비 (Thread 생성 전, 0 : 사용 안함)
+	char* alloc(const int size);							// size 이상인 크기의 block
+	void release(char* pBlock, const int size);
+	char* alloc_mirror(const int size);						// size : page 크기 단위 (실패 nullptr)
+	void release_mirror(char* pBase, const int size);
+	static int get_class_size(const int size);				// 실제로 빌려주는 크기 (POOL_MIN_CLASS 배수)
+	void logStats();
+	static void benchmark(const int loopCnt);				// Pool 에서 빌리기 / 돌려주기와 new / delete, mirror 생성 비교
+
+private:
+	struct Size_Class {
+		std::mutex mLock;
+		std::vector<char*> freeBlocks;
+		std::vector<char*> freeMirrors;
+		std::vector<char*> idleMirrors;						// 보관 크기를 넘어서 page 를 해제한 mirror (map 만 남아 있다)
+		std::atomic<int> inUse{ 0 };						// 빌려준 linear block 수
+		std::atomic<int> mirrorInUse{ 0 };					// 빌려준 mirror 수
+		std::atomic<int> created{ 0 };						// 만든 linear block 수 (현재)
+		std::atomic<int> mirrorCreated{ 0 };				// 만든 mirror 수 (현재)
+	};
+	Size_Class classes[POOL_CLASS_CNT];
+	char* arenaBase = nullptr;
+	size_t arenaSize = 0;
+	std::atomic<size_t> arenaUsed{ 0 };
+	bool arenaHuge = false;									// MAP_HUGETLB 로 받았는가 (아니면 THP madvise)
+	int idleMirrorMax = get_idle_mirror_max();				// 크기 별 idleMirrors 최대 수
+	static int get_class_no(const int size);
+	static int get_idle_mirror_max();
+	bool in_arena(char* pBlock) { return pBlock >= arenaBase && pBlock < arenaBase + arenaSize; }
+	char* alloc_arena(const int classSize);
+	char* create_mirror(const int size);
+	void free_block(char* pBlock);
+	void free_mirror(char* pBase, const int size);
+};
+
+#endif
@@ -0,0 +1,66 @@
+﻿#include "ChainBuffer.h"
+
+Chain_Buffer::Chain_Buffer(const int frameSize)
+{
+	this->frameSize = frameSize;
+	filled = 0;
+	int blockCnt = (frameSize + CHAIN_BLOCK_SIZE - 1) / CHAIN_BLOCK_SIZE;
+	blocks.reserve(blockCnt);
+	for (int i = 0; i < blockCnt; i++) {
+		blocks.emplace_back(buffer_pool.alloc(CHAIN_BLOCK_SIZE));
+	}
+}
+
+Chain_Buffer::~Chain_Buffer()
+{
+	for (auto pBlock : blocks) {
+		buffer_pool.release(pBlock, CHAIN_BLOCK_SIZE);
+	}
+	blocks.clear();
+}
+
+int Chain_Buffer::append(const char * pData, const int size)
+{
+	int copySize = std::min(size, get_remain());
+	int copied = 0;
+	while (copied < copySize) {
+		int offset = filled % CHAIN_BLOCK_SIZE;
+		int chunk = std::min(copySize - copied, CHAIN_BLOCK_SIZE - offset);
+		memcpy(blocks[filled / CHAIN_BLOCK_SIZE] + offset, pData + copied, chunk);
+		filled += chunk;
+		copied += chunk;
+	}
+	return copySize;
+}
+
+int Chain_Buffer::prepare_iov(struct iovec * iov, const int maxIov)
+{
+	// 다음 Packet 을 읽지 않도록 frameSize 까지만 채운다.
+	int iovCnt = 0;
+	int pos = filled;
+	while (pos < frameSize && iovCnt < maxIov) {
+		int offset = pos % CHAIN_BLOCK_SIZE;
+		int chunk = std::min(frameSize - pos, CHAIN_BLOCK_SIZE - offset);
+		iov[iovCnt].iov_base = blocks[pos / CHAIN_BLOCK_SIZE] + offset;
+		iov[iovCnt].iov_len = chunk;
+		iovCnt++;
+		pos += chunk;
+	}
+	return iovCnt;
+}
+
+void Chain_Buffer::commit(const int size)
+{
+	filled = std::min(filled + size, frameSize);
+}
+
+void Chain_Buffer::copy_to(char * pOut)
+{
+	int copied = 0;
+	for (auto pBlock : blocks) {
+		if (copied >= filled) break;
+		int chunk = std::min(filled - copied, CHAIN_BLOCK_SIZE);
+		memcpy(pOut + copied, pBlock, chunk);
+		copied += chunk;
+	}
+}
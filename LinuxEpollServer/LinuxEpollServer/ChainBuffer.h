@@ -0,0 +1,34 @@
+﻿#ifndef __CHAINBUFFER_H__
+#define __CHAINBUFFER_H__
+
+#include "Main.h"
+
+#include <sys/uio.h>
+
+#define CHAIN_BLOCK_SIZE MAX_SOCKBUF						// block 크기
+#define CHAIN_MAX_IOV ((65535 + CHAIN_BLOCK_SIZE - 1) / CHAIN_BLOCK_SIZE)	// packet_len (unsigned short) 최대 block 수
+
+// MAX_SOCKBUF 보다 큰 Packet 하나를 block 을 이어서 받는다.
+// 큰 Packet 의 Header 를 받은 세션만 만들고, 다 받으면 block 을 Buffer_Pool 로 돌려준다. (세션 당 고정 메모리는 포인터 하나)
+// readv 로 block 에 바로 받고, Logic_API 로 넘길 때 한번만 이어 붙인다.
+class Chain_Buffer {
+public:
+	Chain_Buffer(const int frameSize);						// frameSize 만큼 block 을 빌린다.
+	~Chain_Buffer();										// block 반납
+	int append(const char* pData, const int size);			// 복사 (ReadBuffer 에 남은 앞부분, io_uring 수신)
+	int prepare_iov(struct iovec* iov, const int maxIov);	// 남은 크기 만큼 readv 용 iovec
+	void commit(const int size);							// readv 로 받은 크기
+	void copy_to(char* pOut);								// 받은 만큼 이어 붙인다.
+	bool is_complete() { return filled == frameSize; }
+	int get_frame_size() { return frameSize; }
+	int get_filled() { return filled; }
+	int get_remain() { return frameSize - filled; }
+	int get_block_cnt() { return (int)blocks.size(); }
+
+private:
+	std::vector<char*> blocks;
+	int frameSize;
+	int filled;
+};
+
+#endif
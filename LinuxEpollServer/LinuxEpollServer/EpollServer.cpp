@@ -1,11 +1,48 @@
 #include "EpollServer.h"
 
+// SendPacket  ȣ Thread      
+static thread_local std::vector<session_handle> pendingFlush;
+
+// Worker / Reactor Thread   Buffer (SHARED_RECV_BUFFER)
+static thread_local std::vector<char> sharedRecvBuffer;
+
+static char* getSharedRecvBuffer()
+{
+	if (sharedRecvBuffer.empty()) {
+		sharedRecvBuffer.resize(SHARED_RECV_SIZE);
+	}
+	return sharedRecvBuffer.data();
+}
+
 Epoll_Server::Epoll_Server()
 {
 	memset(&ev, 0, sizeof ev);
 	mIsEventThreadRun = false;
 	mIsWorkerThreadRun = false;
-	disconnectUniqueNo.clear();
+	sendPacketCnt = 0;
+	sendCallCnt = 0;
+	staleHandleCnt = 0;
+	broadcastCnt = 0;
+	broadcastTargetCnt = 0;
+	idleCloseCnt = 0;
+	pingCnt = 0;
+	pausedSessionCnt = 0;
+	readPauseCnt = 0;
+	readResumeCnt = 0;
+	acceptCnt = 0;
+	acceptWakeCnt = 0;
+	chainFrameCnt = 0;
+	chainReadCnt = 0;
+	sharedRecvCnt = 0;
+	carryoverCnt = 0;
+	carryoverBytes = 0;
+	lastAcceptCnt = 0;
+	baseRssKB = 0;
+	lastAcceptTime = std::chrono::steady_clock::now();
+	mUringEngine = nullptr;
+	mSessionPool = nullptr;
+	shutdownFd = -1;
+	mInheritListen = false;
 	// ӽ uniqueNo ߰
 	for (int i = 0; i < UNIQUE_START_NO; ++i) {
 		tempUniqueNo.push(i);
@@ -18,11 +55,46 @@ Epoll_Server::~Epoll_Server()
 
 void Epoll_Server::init_server()
 {
+	// MAX_PLAYER ŭ  ̸ .
+	mSessionPool = new Session_Pool;
+	if (!mSessionPool->init_pool(CS.get_max_player())) {
+		exit(EXIT_FAILURE);
+	}
+	baseRssKB = getRssKB();
+
+	//  epoll_wait   Thread   . (Level Trigger)
+	if ((shutdownFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0) {
+		spdlog::error("eventfd() Function failure : {}", strerror(errno));
+	}
+
+	// io_uring  : Engine Thread ϳ accept / recv  óѴ.
+	if (CS.get_io_engine() == IO_ENGINE_URING) {
+		mUringEngine = new Uring_Engine;
+		return;
+	}
+	init_epoll();
+}
+
+void Epoll_Server::init_epoll()
+{
+	// Reactor  : Reactor  epoll, Listen   .
+	if (CS.get_reactor_cnt() > 0) {
+		mReactors.reserve(CS.get_reactor_cnt());
+		for (int i = 0; i < CS.get_reactor_cnt(); i++) {
+			mReactors.emplace_back(new Epoll_Reactor(i));
+		}
+		return;
+	}
+
 	if ((epfd = epoll_create(MAX_EVENTS)) < 0) {
 		spdlog::error("epoll_create() Function failure");
 	}
 
-	if ((sock = socket(PF_INET, SOCK_STREAM, 0)) < 0) {
+	// Hot Restart  Ѱ  Listen  ̹ bind, listen Ǿ ִ.
+	if ((sock = hotRestart.take_listen_sock()) >= 0) {
+		mInheritListen = true;
+	}
+	else if ((sock = socket(PF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)) < 0) {
 		spdlog::error("socket() Function failure");
 		exit(EXIT_FAILURE);
 	}
@@ -31,19 +103,49 @@ void Epoll_Server::init_server()
 
 void Epoll_Server::BindandListen(int port)
 {
+	if (mUringEngine != nullptr) {
+		if (mUringEngine->init_engine(port)) {
+			mUringEngine->start();
+			spdlog::info("Uring Engine Start..! (IO_ENGINE : uring)");
+			return;
+		}
+		// io_uring      epoll  Ѵ.
+		spdlog::error("Uring Engine init failure -> IO_ENGINE : epoll");
+		delete mUringEngine;
+		mUringEngine = nullptr;
+		init_epoll();
+	}
+
+	if (!mReactors.empty()) {
+		for (auto pReactor : mReactors) {
+			if (!pReactor->init_reactor(port)) {
+				spdlog::error("[Reactor:{}] init_reactor() Function failure", pReactor->get_reactor_no());
+				exit(EXIT_FAILURE);
+			}
+			pReactor->start();
+		}
+		// Ÿ̸Ӵ Reactor 0  óѴ.
+		AddEventFd(mReactors[0]->get_epfd(), timer.get_fd());
+		for (auto pReactor : mReactors) {
+			AddEventFd(pReactor->get_epfd(), shutdownFd);
+		}
+		spdlog::info("Epoll Server Reactor Start..! (REACTOR_CNT : {})", mReactors.size());
+		return;
+	}
+
 	memset(&sin, 0, sizeof sin);
 
 	sin.sin_family = AF_INET;
 	sin.sin_addr.s_addr = htonl(INADDR_ANY);
 	sin.sin_port = htons(port);
 
-	if (bind(sock, (struct sockaddr *) &sin, sizeof sin) < 0) {
+	if (!mInheritListen && bind(sock, (struct sockaddr *) &sin, sizeof sin) < 0) {
 		close(sock);
 		spdlog::error("bind() Function failure");
 		exit(EXIT_FAILURE);
 	}
 
-	if (listen(sock, BACKLOG) < 0) {
+	if (!ListenSocket(sock)) {
 		close(sock);
 		spdlog::error("listen() Function failure");
 		exit(EXIT_FAILURE);
@@ -53,65 +155,703 @@ void Epoll_Server::BindandListen(int port)
 	mEventThread = std::thread([this]() { EventThread(); });
 
 	mIsWorkerThreadRun = true;
-	mWorkerThreads.reserve(MAX_WORKERTHREAD + 1);
-	for (int i = 0; i < 1; i++) {
-		mWorkerThreads.emplace_back([this]() { WorkerThread(); });
+	mWorkers.reserve(CS.get_worker_cnt());
+	mWorkerThreads.reserve(CS.get_worker_cnt());
+	for (int i = 0; i < CS.get_worker_cnt(); i++) {
+		WorkerContext *pWorker = new WorkerContext;
+		mWorkers.emplace_back(pWorker);
+		mWorkerThreads.emplace_back([this, pWorker, i]() {
+			topology.bind_thread(THREAD_WORKER, i);
+			WorkerThread(pWorker);
+		});
 	}
 
-	spdlog::info("Epoll Server Thread Start..!");
-	ev.events = EPOLLIN;
+	spdlog::info("Epoll Server Thread Start..! (WORKER_CNT : {})", mWorkers.size());
+	ev.events = EPOLLIN | EPOLLEXCLUSIVE;
 	ev.data.fd = sock;
 	epoll_ctl(epfd, EPOLL_CTL_ADD, sock, &ev);
+	AddEventFd(epfd, timer.get_fd());
+	AddEventFd(epfd, shutdownFd);
+}
+
+bool Epoll_Server::ListenSocket(const int listenSock)
+{
+	// ù  (Auth Login)     accept  ̷.
+	int deferSec = CS.get_defer_accept_sec();
+	if (deferSec > 0 && setsockopt(listenSock, IPPROTO_TCP, TCP_DEFER_ACCEPT, &deferSec, sizeof deferSec) < 0) {
+		spdlog::error("setsockopt(TCP_DEFER_ACCEPT) Function failure : {}", strerror(errno));
+	}
+
+	// Ŀ net.core.somaxconn  δ.
+	if (listen(listenSock, CS.get_listen_backlog()) < 0) {
+		spdlog::error("listen() Function failure : {}", strerror(errno));
+		return false;
+	}
+	return true;
 }
 
 void Epoll_Server::add_tempUniqueNo(unsigned_int64 uniqueNo)
 {
+	std::lock_guard<std::mutex> guard(mSessionLock);
 	tempUniqueNo.push(uniqueNo);
 }
 
-bool Epoll_Server::SendPacket(int sock, char* pMsg, int nLen)
+bool Epoll_Server::ChangeUniqueNo(const session_handle handle, const unsigned_int64 uniqueNo)
 {
-	auto pPlayerSession = getSessionByNo(sock);
+	// ClosePlayer    (mSessionLock -> send_mutex)  Ƽ ӽ uniqueNo    ݳѴ.
+	std::lock_guard<std::mutex> guard(mSessionLock);
+	auto pPlayerSession = mSessionPool->find_handle(handle);
+	if (pPlayerSession == nullptr) {
+		return false;
+	}
+	unsigned_int64 oldUniqueNo;
+	{
+		std::lock_guard<std::mutex> sendGuard(pPlayerSession->send_mutex());
+		if (pPlayerSession->get_handle() != handle) {
+			return false;
+		}
+		oldUniqueNo = pPlayerSession->get_unique_no();
+		pPlayerSession->set_unique_no(uniqueNo);
+		// ÷̾ ǰ  slot  ϹǷ ȣ ٲش.
+		mSessionPool->find_player_handle(handle)->set_unique_no(uniqueNo);
+	}
+	//  ӽ uniqueNo  ٽ  ش. (α ̸ ̹ ӽ ȣ ƴϴ)
+	if (oldUniqueNo < UNIQUE_START_NO) {
+		tempUniqueNo.push(oldUniqueNo);
+	}
+	return true;
+}
+
+bool Epoll_Server::SendPacket(session_handle handle, char* pMsg, int nLen)
+{
+	auto pPlayerSession = getSessionByHandle(handle);
 	if (pPlayerSession != nullptr) {
-		// send_Buffer pMsg ־ش.
-		pPlayerSession->sendReady(pMsg, nLen);
-		// Sendó Ѵ.
-		return pPlayerSession->sendIo();
+		std::lock_guard<std::mutex> guard(pPlayerSession->send_mutex());
+		// lock  ٸ   () Ǿ  ǿ  ʴ´.
+		if (pPlayerSession->get_handle() == handle) {
+			// sendQueue pMsg ־ش.
+			pPlayerSession->sendReady(pMsg, nLen);
+			sendPacketCnt.fetch_add(1, std::memory_order_relaxed);
+			MarkSendPending(pPlayerSession, handle);
+			return true;
+		}
 	}
-	else {
+	// ̹  ()   ̴.
+	staleHandleCnt.fetch_add(1, std::memory_order_relaxed);
+	return false;
+}
+
+int Epoll_Server::BroadcastPacket(const session_handle * handles, const int handleCnt, char * pMsg, int nLen)
+{
+	// ѹ ϰ    ø. (   ´)
+	Shared_Buffer *pShared = Shared_Buffer::create(pMsg, nLen);
+	int sendCnt = 0;
+	for (int i = 0; i < handleCnt; i++) {
+		auto pPlayerSession = getSessionByHandle(handles[i]);
+		if (pPlayerSession == nullptr) {
+			staleHandleCnt.fetch_add(1, std::memory_order_relaxed);
+			continue;
+		}
+		std::lock_guard<std::mutex> guard(pPlayerSession->send_mutex());
+		if (pPlayerSession->get_handle() != handles[i]) {
+			staleHandleCnt.fetch_add(1, std::memory_order_relaxed);
+			continue;
+		}
+		pShared->add_ref();
+		pPlayerSession->sendReadyShared(pShared);
+		MarkSendPending(pPlayerSession, handles[i]);
+		sendCnt++;
+	}
+	pShared->release();
+	sendPacketCnt.fetch_add(sendCnt, std::memory_order_relaxed);
+	broadcastCnt.fetch_add(1, std::memory_order_relaxed);
+	broadcastTargetCnt.fetch_add(sendCnt, std::memory_order_relaxed);
+	return sendCnt;
+}
+
+void Epoll_Server::MarkSendPending(PLAYER_Session * pPlayerSession, session_handle handle)
+{
+	//  ʴ Ŭ̾Ʈ  缭  ̻   ϰ Ѵ.
+	UpdateBackpressure(pPlayerSession);
+	// EPOLLOUT ̸ Worker ̾ .
+	if (pPlayerSession->get_sendArmed()) {
+		return;
+	}
+	//   ó    FlushSendAll  ѹ Ѵ.
+	if (!pPlayerSession->get_sendDirty()) {
+		pPlayerSession->set_sendDirty(true);
+		pendingFlush.emplace_back(handle);
+	}
+}
+
+void Epoll_Server::benchmarkBroadcast(const int recipientCnt, const int packetSize)
+{
+	//    sendQueue  ְ (enqueue)  Ϸ (sendFinish)  Ѵ.
+	//  write    Ƿ  / Ҵ 븸  ȴ.
+	PLAYER_Session *pSessions = new PLAYER_Session[recipientCnt];
+	std::vector<char> packet(packetSize, 'b');
+	const int roundCnt = 100;
+	auto elapsedUs = [](std::chrono::steady_clock::time_point begin) {
+		return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+	};
+
+	// SendPacket  :   
+	auto begin = std::chrono::steady_clock::now();
+	for (int round = 0; round < roundCnt; round++) {
+		for (int i = 0; i < recipientCnt; i++) {
+			pSessions[i].sendReady(packet.data(), packetSize);
+		}
+		for (int i = 0; i < recipientCnt; i++) {
+			pSessions[i].sendFinish(packetSize);
+		}
+	}
+	double copyUs = elapsedUs(begin) / roundCnt;
+
+	// Broadcast  : ѹ   
+	begin = std::chrono::steady_clock::now();
+	for (int round = 0; round < roundCnt; round++) {
+		Shared_Buffer *pShared = Shared_Buffer::create(packet.data(), packetSize);
+		for (int i = 0; i < recipientCnt; i++) {
+			pShared->add_ref();
+			pSessions[i].sendReadyShared(pShared);
+		}
+		pShared->release();
+		for (int i = 0; i < recipientCnt; i++) {
+			pSessions[i].sendFinish(packetSize);
+		}
+	}
+	double sharedUs = elapsedUs(begin) / roundCnt;
+
+	spdlog::info("[Broadcast Bench] recipients : {}, packet : {} byte, copy : {:.1f}us, shared : {:.1f}us, copied bytes : {} -> {}",
+		recipientCnt, packetSize, copyUs, sharedUs, (unsigned_int64)recipientCnt * packetSize, packetSize);
+	delete[] pSessions;
+}
+
+void Epoll_Server::benchmarkRecv(const int sessionCnt, const int packetSize, const int recvSize)
+{
+	//    ư recvSize  ޴´. (read  memcpy, Logic_API  ѱ  checksum)
+	// eager :  Buffer    ִ´. (   Buffer)
+	// lazy :   Buffer_Pool  ش.
+	// shared : Thread  Buffer  ް,    Buffer  ű.
+	const long long totalBytes = 256LL * 1024 * 1024;
+	const char* modeNames[] = { "eager", "lazy", "shared" };
+
+	//  Packet  ̾  ۽  (  ġ : 0 ~ packetSize - 1)
+	std::vector<char> stream((recvSize / packetSize + 2) * packetSize);
+	for (int pos = 0; pos + packetSize <= (int)stream.size(); pos += packetSize) {
+		PACKET_HEADER header{ (unsigned short)packetSize, CLIENT_AUTH_TEST2 };
+		memset(&stream[pos], 'v', packetSize);
+		memcpy(&stream[pos], &header, sizeof(header));
+	}
+
+	for (int mode = 0; mode < 3; mode++) {
+		ReadBuffer *pBuffers = new ReadBuffer[sessionCnt];
+		std::vector<int> streamPos(sessionCnt, 0);
+		for (int i = 0; i < sessionCnt; i++) {
+			pBuffers[i].init(MAX_SOCKBUF, CS.get_read_buffer_mirror());
+		}
+		std::vector<char> shared(SHARED_RECV_SIZE);
+		FRAME_View frames[MAX_FRAME_BATCH];
+		long long recvBytes = 0;
+		long long packetCnt = 0;
+		long long carryBytes = 0;
+		unsigned int checkSum = 0;
+		auto begin = std::chrono::steady_clock::now();
+		for (int session = 0; recvBytes < totalBytes; session = (session + 1) % sessionCnt) {
+			auto& readBuffer = pBuffers[session];
+			const char* pRecv = &stream[streamPos[session]];
+			int ioSize = recvSize;
+			if (mode == 2 && readBuffer.getReadAbleSize() == 0) {
+				// OnRecvShared
+				memcpy(shared.data(), pRecv, recvSize);
+				int offset = 0;
+				int readSize = 0;
+				int frameCnt;
+				while ((frameCnt = PacketDecoder::decode(shared.data() + offset, recvSize - offset, frames, MAX_FRAME_BATCH, readSize)) > 0) {
+					checkSum += (unsigned char)frames[frameCnt - 1].pMsg[frames[frameCnt - 1].size - 1];
+					packetCnt += frameCnt;
+					offset += readSize;
+				}
+				if (offset < recvSize) {
+					if (readBuffer.setWriteBuffer(shared.data() + offset, recvSize - offset) < 0) {
+						break;
+					}
+					carryBytes += recvSize - offset;
+				}
+			}
+			else {
+				// OnRecv
+				readBuffer.checkWrite(MIN_SOCKBUF);
+				ioSize = std::min(recvSize, readBuffer.getWriteAbleSize());
+				memcpy(readBuffer.getWriteBuffer(), pRecv, ioSize);
+				readBuffer.moveWritePos(ioSize);
+				int readSize = 0;
+				int frameCnt;
+				while ((frameCnt = PacketDecoder::decode(readBuffer.getReadBuffer(), readBuffer.getReadAbleSize(), frames, MAX_FRAME_BATCH, readSize)) > 0) {
+					checkSum += (unsigned char)frames[frameCnt - 1].pMsg[frames[frameCnt - 1].size - 1];
+					packetCnt += frameCnt;
+					readBuffer.moveReadPos(readSize);
+				}
+				if (mode != 0) {
+					readBuffer.releaseIfEmpty();
+				}
+			}
+			streamPos[session] = (streamPos[session] + ioSize) % packetSize;
+			recvBytes += ioSize;
+		}
+		double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+		int heldCnt = 0;
+		for (int i = 0; i < sessionCnt; i++) {
+			if (pBuffers[i].is_acquired()) heldCnt++;
+		}
+		spdlog::info("[Recv Bench] {} sessions : {}, packet : {} byte, recv : {} byte, ns/packet : {:.1f}, MB/sec : {:.0f}, buffers held : {} ({} KB), carryover : {} MB (checksum {})",
+			modeNames[mode], sessionCnt, packetSize, recvSize, packetCnt > 0 ? sec * 1e9 / packetCnt : 0.0, sec > 0 ? recvBytes / sec / (1024 * 1024) : 0.0,
+			heldCnt, (long long)heldCnt * pBuffers[0].get_total_size() / 1024, carryBytes / (1024 * 1024), checkSum);
+		delete[] pBuffers;
+	}
+}
+
+void Epoll_Server::FlushSendAll()
+{
+	for (auto handle : pendingFlush) {
+		auto pPlayerSession = getSessionByHandle(handle);
+		if (pPlayerSession == nullptr) continue;
+		std::lock_guard<std::mutex> guard(pPlayerSession->send_mutex());
+		if (pPlayerSession->get_handle() != handle) continue;
+		pPlayerSession->set_sendDirty(false);
+		if (pPlayerSession->get_sendArmed()) continue;
+		//   EPOLLERR / EPOLLRDHUP   ó Ѵ.
+		FlushSend(pPlayerSession);
+	}
+	pendingFlush.clear();
+}
+
+bool Epoll_Server::FlushSend(PLAYER_Session * pPlayerSession)
+{
+	// send_mutex   ¿ ȣ Ѵ.
+	int callCnt = 0;
+	SendResult result = pPlayerSession->sendIo(callCnt);
+	sendCallCnt.fetch_add(callCnt, std::memory_order_relaxed);
+	if (result == SEND_ERROR) {
 		return false;
 	}
-	return false;
+
+	//   Packet     EPOLLOUT  Ѵ.
+	bool needArm = (result == SEND_PENDING);
+	if (needArm != pPlayerSession->get_sendArmed()) {
+		pPlayerSession->set_sendArmed(needArm);
+		if (pPlayerSession->get_reactor_no() == URING_REACTOR_NO) {
+			// io_uring  : POLLOUT  1ȸ ̹Ƿ ϸ Ѵ.
+			if (needArm) {
+				mUringEngine->requestPollOut(pPlayerSession->get_handle());
+			}
+		}
+		else {
+			ModEpollSession(pPlayerSession);
+		}
+	}
+
+	//  Ⱑ پ   ٽ Ѵ.
+	UpdateBackpressure(pPlayerSession);
+	return true;
+}
+
+void Epoll_Server::ModEpollSession(PLAYER_Session * pPlayerSession)
+{
+	struct epoll_event clientEv;
+	memset(&clientEv, 0, sizeof clientEv);
+	clientEv.events = EPOLLRDHUP | EPOLLET;
+	if (!pPlayerSession->get_readPaused()) {
+		clientEv.events |= EPOLLIN;
+	}
+	if (pPlayerSession->get_sendArmed()) {
+		clientEv.events |= EPOLLOUT;
+	}
+	clientEv.data.fd = pPlayerSession->get_sock();
+	epoll_ctl(get_epfd(pPlayerSession->get_reactor_no()), EPOLL_CTL_MOD, pPlayerSession->get_sock(), &clientEv);
+}
+
+void Epoll_Server::UpdateBackpressure(PLAYER_Session * pPlayerSession)
+{
+	int sendHigh = CS.get_send_high_water();
+	int frameHigh = CS.get_frame_high_water();
+	int sendSize = pPlayerSession->get_sendPendingSize();
+	int frameCnt = pPlayerSession->get_queued_frames();
+
+	if (!pPlayerSession->get_readPaused()) {
+		if ((sendHigh == 0 || sendSize < sendHigh) && (frameHigh == 0 || frameCnt < frameHigh)) {
+			return;
+		}
+		pPlayerSession->set_readPaused(true);
+		pausedSessionCnt.fetch_add(1, std::memory_order_relaxed);
+		readPauseCnt.fetch_add(1, std::memory_order_relaxed);
+	}
+	else {
+		//    LOW WATER   簳 Ѵ.
+		if ((sendHigh != 0 && sendSize > CS.get_send_low_water()) || (frameHigh != 0 && frameCnt > CS.get_frame_low_water())) {
+			return;
+		}
+		pPlayerSession->set_readPaused(false);
+		pausedSessionCnt.fetch_sub(1, std::memory_order_relaxed);
+		readResumeCnt.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	// Edge Trigger  EPOLL_CTL_MOD  EPOLLIN  ٽ   Ͱ ٽ ˷.
+	if (pPlayerSession->get_reactor_no() == URING_REACTOR_NO) {
+		mUringEngine->requestRecvCtl(pPlayerSession->get_handle(), pPlayerSession->get_readPaused());
+	}
+	else {
+		ModEpollSession(pPlayerSession);
+	}
+}
+
+void Epoll_Server::OnPacketDone(const session_handle handle)
+{
+	auto pPlayerSession = getSessionByHandle(handle);
+	if (pPlayerSession == nullptr) return;
+
+	//   ,    ó    ʴ´. (  0  )
+	std::lock_guard<std::mutex> sendGuard(pPlayerSession->send_mutex());
+	if (pPlayerSession->get_handle() != handle) return;
+	pPlayerSession->add_queued_frames(-1);
+	if (pPlayerSession->get_readPaused()) {
+		UpdateBackpressure(pPlayerSession);
+	}
 }
 
 PLAYER_Session * Epoll_Server::getSessionByNo(int sock)
 {
-	auto pTempPlayerSession = player_session.find(sock);
-	if (pTempPlayerSession == player_session.end()) {
-		if (disconnectUniqueNo.find(sock) == disconnectUniqueNo.end()) {
-			spdlog::error("[getSessionByNo] No Exit Session || [socketNo:{}]", sock);
-			disconnectUniqueNo.insert(pair<int, bool>(sock, true));
+	// fd ̺  ٷ ´. (lock ,  fd  nullptr)
+	return mSessionPool->find(sock);
+}
+
+PLAYER_Session * Epoll_Server::getSessionByHandle(session_handle handle)
+{
+	// slot  generation    ´.
+	return mSessionPool->find_handle(handle);
+}
+
+PLAYER * Epoll_Server::getPlayerByHandle(session_handle handle)
+{
+	return mSessionPool->find_player_handle(handle);
+}
+
+void Epoll_Server::AddEpollSession(const int sock, const int reactorNo)
+{
+	// accept4  SOCK_NONBLOCK  ޾Ƿ fcntl  ʿ .
+	if (reactorNo == URING_REACTOR_NO) {
+		// io_uring  epoll   ʴ´.
+		return;
+	}
+
+	struct epoll_event clientEv;
+	memset(&clientEv, 0, sizeof clientEv);
+	clientEv.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+	clientEv.data.fd = sock;
+	epoll_ctl(get_epfd(reactorNo), EPOLL_CTL_ADD, sock, &clientEv);
+}
+
+void Epoll_Server::AddEventFd(const int targetEpfd, const int fd)
+{
+	if (fd < 0) {
+		return;
+	}
+	struct epoll_event fdEv;
+	memset(&fdEv, 0, sizeof fdEv);
+	fdEv.events = EPOLLIN;
+	fdEv.data.fd = fd;
+	if (epoll_ctl(targetEpfd, EPOLL_CTL_ADD, fd, &fdEv) < 0) {
+		spdlog::error("epoll_ctl({}) Function failure : {}", fd, strerror(errno));
+	}
+}
+
+int Epoll_Server::get_epfd(const int reactorNo)
+{
+	if (reactorNo < 0) {
+		return epfd;
+	}
+	return mReactors[reactorNo]->get_epfd();
+}
+
+void Epoll_Server::logWorkerStats()
+{
+	unsigned_int64 totalCnt = 0;
+	for (size_t i = 0; i < mWorkers.size(); i++) {
+		unsigned_int64 eventCnt = mWorkers[i]->eventCnt.load(std::memory_order_relaxed);
+		totalCnt += eventCnt;
+		spdlog::info("[Worker:{}] events : {}", i, eventCnt);
+	}
+	spdlog::info("[Worker] WORKER_CNT : {}, total events : {}", mWorkers.size(), totalCnt);
+}
+
+void Epoll_Server::logSendStats()
+{
+	unsigned_int64 packetCnt = sendPacketCnt.load(std::memory_order_relaxed);
+	unsigned_int64 callCnt = sendCallCnt.load(std::memory_order_relaxed);
+	spdlog::info("[Send] packets : {}, sendmsg calls : {}, calls per packet : {:.3f}, stale handles : {}",
+		packetCnt, callCnt, packetCnt > 0 ? (double)callCnt / packetCnt : 0.0, staleHandleCnt.load(std::memory_order_relaxed));
+	spdlog::info("[Send] broadcasts : {}, broadcast targets : {}", broadcastCnt.load(std::memory_order_relaxed), broadcastTargetCnt.load(std::memory_order_relaxed));
+}
+
+void Epoll_Server::logAcceptStats()
+{
+	auto now = std::chrono::steady_clock::now();
+	double elapsed = std::chrono::duration<double>(now - lastAcceptTime).count();
+	unsigned_int64 totalCnt = acceptCnt.load(std::memory_order_relaxed);
+	unsigned_int64 wakeCnt = acceptWakeCnt.load(std::memory_order_relaxed);
+	spdlog::info("[Accept] accepted : {}, listen events : {}, accepts per second : {:.1f}, sessions : {} / {}",
+		totalCnt, wakeCnt, elapsed > 0 ? (totalCnt - lastAcceptCnt) / elapsed : 0.0, mSessionPool->get_use_cnt(), mSessionPool->get_max_cnt());
+	lastAcceptCnt = totalCnt;
+	lastAcceptTime = now;
+}
+
+void Epoll_Server::logIdleStats()
+{
+	spdlog::info("[Idle] IDLE_TIMEOUT_SEC : {}, PING_INTERVAL_SEC : {}, idle closed : {}, ping : {}",
+		CS.get_idle_timeout_sec(), CS.get_ping_interval_sec(), idleCloseCnt.load(std::memory_order_relaxed), pingCnt.load(std::memory_order_relaxed));
+}
+
+void Epoll_Server::logBackpressureStats()
+{
+	spdlog::info("[Backpressure] SEND_WATER : {} / {}, FRAME_WATER : {} / {}, paused sessions : {}, pause : {}, resume : {}",
+		CS.get_send_high_water(), CS.get_send_low_water(), CS.get_frame_high_water(), CS.get_frame_low_water(),
+		pausedSessionCnt.load(std::memory_order_relaxed), readPauseCnt.load(std::memory_order_relaxed), readResumeCnt.load(std::memory_order_relaxed));
+	//  ߴ    ⷮ
+	for (int slot = 0; slot < mSessionPool->get_max_cnt(); slot++) {
+		auto pPlayerSession = mSessionPool->find_slot(slot);
+		if (pPlayerSession == nullptr || !pPlayerSession->get_readPaused()) continue;
+		std::lock_guard<std::mutex> sendGuard(pPlayerSession->send_mutex());
+		spdlog::info("[Backpressure] SOCKET : {}, send pending : {}, queued frames : {}, pause : {} || [unique_no:{}]",
+			(int)pPlayerSession->get_sock(), pPlayerSession->get_sendPendingSize(), pPlayerSession->get_queued_frames(),
+			pPlayerSession->get_pause_cnt(), pPlayerSession->get_unique_no());
+	}
+}
+
+void Epoll_Server::logChainStats()
+{
+	spdlog::info("[Chain] MAX_PACKET_SIZE : {}, large packets : {}, readv : {}",
+		CS.get_max_packet_size(), chainFrameCnt.load(std::memory_order_relaxed), chainReadCnt.load(std::memory_order_relaxed));
+}
+
+long long Epoll_Server::getRssKB()
+{
+	FILE* pFile = fopen("/proc/self/statm", "r");
+	if (pFile == nullptr) return 0;
+	long long totalPages = 0, residentPages = 0;
+	if (fscanf(pFile, "%lld %lld", &totalPages, &residentPages) != 2) {
+		residentPages = 0;
+	}
+	fclose(pFile);
+	return residentPages * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+void Epoll_Server::logMemoryStats()
+{
+	//  Pool   þ RSS    . (Buffer, Ŀ   ޸)
+	long long rssKB = getRssKB();
+	int sessionCnt = mSessionPool != nullptr ? mSessionPool->get_use_cnt() : 0;
+	spdlog::info("[Memory] RSS : {} KB (session pool base : {} KB), sessions : {}, RSS per session : {:.2f} KB, session size : {} byte",
+		rssKB, baseRssKB, sessionCnt, sessionCnt > 0 ? (double)(rssKB - baseRssKB) / sessionCnt : 0.0, sizeof(PLAYER_Session));
+	buffer_pool.logStats();
+}
+
+void Epoll_Server::logRecvStats()
+{
+	unsigned_int64 sharedCnt = sharedRecvCnt.load(std::memory_order_relaxed);
+	unsigned_int64 carryCnt = carryoverCnt.load(std::memory_order_relaxed);
+	spdlog::info("[Recv] SHARED_RECV_BUFFER : {}, shared recv : {}, carryover : {} ({:.1f}%), carryover bytes : {}",
+		CS.get_shared_recv_buffer() ? 1 : 0, sharedCnt, carryCnt, sharedCnt > 0 ? carryCnt * 100.0 / sharedCnt : 0.0,
+		carryoverBytes.load(std::memory_order_relaxed));
+}
+
+void Epoll_Server::logReactorStats()
+{
+	if (mUringEngine != nullptr) {
+		mUringEngine->logStats();
+	}
+	for (auto pReactor : mReactors) {
+		spdlog::info("[Reactor:{}] sessions : {}, accepted : {}", pReactor->get_reactor_no(), pReactor->get_session_cnt(), pReactor->get_accept_cnt());
+	}
+}
+
+void Epoll_Server::Shutdown(const int drainSec)
+{
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(drainSec);
+	spdlog::info("[Shutdown] Start (SHUTDOWN_DRAIN_SEC : {}, sessions : {})", drainSec, mSessionPool->get_use_cnt());
+
+	// 1. ű ,  ߴ
+	StopIoThreads();
+	CloseListenSockets();
+
+	// 2. Logic_API   Packet ó (Redis  )
+	api.stop(deadline);
+
+	// 3.  sendQueue 
+	int unsentCnt = DrainSendQueue(deadline);
+
+	// 4.   
+	int closeCnt = CloseAllSessions();
+	spdlog::info("[Shutdown] closed sessions : {}, unsent sessions : {}", closeCnt, unsentCnt);
+}
+
+void Epoll_Server::StopIoThreads()
+{
+	udp.stop();
+	if (mUringEngine != nullptr) {
+		mUringEngine->stop();
+	}
+
+	// shutdownFd   Ƿ ѹ write   epoll_wait  .
+	for (auto pReactor : mReactors) {
+		pReactor->stop();
+	}
+	mIsEventThreadRun = false;
+	if (shutdownFd >= 0) {
+		uint64_t value = 1;
+		if (write(shutdownFd, &value, sizeof value) < 0) {
+			// counter overflow
 		}
-		return nullptr;
 	}
-	auto pPlayerSession = pTempPlayerSession->second;
+	for (auto pReactor : mReactors) {
+		pReactor->join();
+	}
+	if (mEventThread.joinable()) {
+		mEventThread.join();
+	}
 
-	return pPlayerSession;
+	// Worker  eventfd  . (Queue   event  ó ʴ´)
+	mIsWorkerThreadRun = false;
+	for (auto pWorker : mWorkers) {
+		pWorker->event_Queue.notify();
+	}
+	for (auto &workerThread : mWorkerThreads) {
+		if (workerThread.joinable()) {
+			workerThread.join();
+		}
+	}
+	spdlog::info("[Shutdown] I/O Thread stopped");
 }
 
-void Epoll_Server::SetNonBlocking(int sock)
+void Epoll_Server::ResumeIoThreads()
 {
-	int flag = fcntl(sock, F_GETFL, 0);
-	fcntl(sock, F_SETFL, flag | O_NONBLOCK);
+	// shutdownFd   Ƿ    epoll_wait  ٽ .
+	uint64_t value;
+	if (shutdownFd >= 0 && read(shutdownFd, &value, sizeof value) < 0) {
+		// EAGAIN (̹  ִ)
+	}
 
-	memset(&ev, 0, sizeof ev);
-	ev.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
-	ev.data.fd = sock;
-	epoll_ctl(epfd, EPOLL_CTL_ADD, sock, &ev);
+	mIsWorkerThreadRun = true;
+	mWorkerThreads.clear();
+	for (int i = 0; i < (int)mWorkers.size(); i++) {
+		WorkerContext *pWorker = mWorkers[i];
+		mWorkerThreads.emplace_back([this, pWorker, i]() {
+			topology.bind_thread(THREAD_WORKER, i);
+			WorkerThread(pWorker);
+		});
+	}
+	if (mUringEngine != nullptr) {
+		if (!mUringEngine->resume()) {
+			spdlog::error("[Uring] resume failure -> I/O stopped");
+		}
+	}
+	else if (!mReactors.empty()) {
+		for (auto pReactor : mReactors) {
+			pReactor->start();
+		}
+	}
+	else {
+		mIsEventThreadRun = true;
+		mEventThread = std::thread([this]() { EventThread(); });
+	}
+	udp.start(CS.get_udp_port());
+	spdlog::info("[HotRestart] I/O Thread resumed");
+}
+
+void Epoll_Server::CloseListenSockets()
+{
+	if (mUringEngine != nullptr) {
+		mUringEngine->close_listen();
+		return;
+	}
+	for (auto pReactor : mReactors) {
+		pReactor->close_listen();
+	}
+	if (mReactors.empty()) {
+		close(sock);
+	}
+}
+
+std::vector<int> Epoll_Server::get_listen_socks()
+{
+	std::vector<int> listenSocks;
+	if (mUringEngine != nullptr) {
+		listenSocks.emplace_back(mUringEngine->get_listen_sock());
+	}
+	else if (!mReactors.empty()) {
+		for (auto pReactor : mReactors) {
+			listenSocks.emplace_back(pReactor->get_listen_sock());
+		}
+	}
+	else {
+		listenSocks.emplace_back(sock);
+	}
+	return listenSocks;
+}
+
+PLAYER_Session * Epoll_Server::getSessionBySlot(const int slot)
+{
+	return mSessionPool->find_slot(slot);
+}
+
+int Epoll_Server::get_max_session()
+{
+	return mSessionPool->get_max_cnt();
+}
+
+int Epoll_Server::DrainSendQueue(const std::chrono::steady_clock::time_point deadline)
+{
+	// I/O Thread  Ƿ EAGAIN  poll  ٸ.
+	int unsentCnt = 0;
+	for (int slot = 0; slot < mSessionPool->get_max_cnt(); slot++) {
+		auto pPlayerSession = mSessionPool->find_slot(slot);
+		if (pPlayerSession == nullptr) continue;
+		std::lock_guard<std::mutex> sendGuard(pPlayerSession->send_mutex());
+		while (pPlayerSession->get_sendPendingSize() > 0) {
+			int callCnt = 0;
+			SendResult result = pPlayerSession->sendIo(callCnt);
+			sendCallCnt.fetch_add(callCnt, std::memory_order_relaxed);
+			if (result != SEND_PENDING) break;
+
+			auto remainMs = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+			struct pollfd sendFd;
+			sendFd.fd = pPlayerSession->get_sock();
+			sendFd.events = POLLOUT;
+			sendFd.revents = 0;
+			if (remainMs <= 0 || poll(&sendFd, 1, (int)remainMs) <= 0) break;
+		}
+		if (pPlayerSession->get_sendPendingSize() > 0) {
+			spdlog::error("[Shutdown] unsent size : {} || [unique_no:{}]", pPlayerSession->get_sendPendingSize(), pPlayerSession->get_unique_no());
+			unsentCnt++;
+		}
+	}
+	return unsentCnt;
+}
+
+int Epoll_Server::CloseAllSessions()
+{
+	int closeCnt = 0;
+	for (int slot = 0; slot < mSessionPool->get_max_cnt(); slot++) {
+		auto pPlayerSession = mSessionPool->find_slot(slot);
+		if (pPlayerSession == nullptr) continue;
+		ClosePlayer(pPlayerSession->get_handle());
+		closeCnt++;
+	}
+	return closeCnt;
 }
 
 void Epoll_Server::EventThread()
 {
+	topology.bind_thread(THREAD_EVENT, 0);
 	int nfds;
 	while (mIsEventThreadRun)
 	{
@@ -134,14 +874,20 @@ void Epoll_Server::EventThread()
 		for (int i = 0; i < nfds; i++) {
 			if (events[i].data.fd == sock) {
 				// ű   ó
-				AcceptProcessing(events[i]);
+				AcceptProcessing(sock, -1);
+			}
+			else if (events[i].data.fd == timer.get_fd()) {
+				//  Ÿ̸ ó
+				timer.OnTick();
+			}
+			else if (events[i].data.fd == shutdownFd) {
+				//  û (mIsEventThreadRun Ȯ)
+				continue;
 			}
 			else {
-				std::lock_guard<std::mutex> guard(mLock);
-				// ش ̺Ʈ event_Queue ־ش.
-				struct epoll_event eev;
-				memcpy(&eev, &events[i], sizeof(events[i]));
-				event_Queue.push(eev);
+				//   ׻  Worker  óϿ Packet  Ѵ.
+				// ش ̺Ʈ event_Queue ־ش. ( Worker eventfd )
+				mWorkers[events[i].data.fd % mWorkers.size()]->event_Queue.push(events[i]);
 			}
 			
 		}
@@ -149,182 +895,626 @@ void Epoll_Server::EventThread()
 	}
 }
 
-void Epoll_Server::WorkerThread()
+void Epoll_Server::WorkerThread(WorkerContext *pWorker)
 {
+	struct epoll_event eventBatch[MAX_EVENTS];
 	while (mIsWorkerThreadRun)
 	{
-		std::lock_guard<std::mutex> guard(mLock);
-		if (!event_Queue.empty()) {
-			auto event = event_Queue.front();
-			event_Queue.pop();
-			//  
-			auto pPlayerSession = getSessionByNo(event.data.fd);
-			if (pPlayerSession == nullptr) continue;
-			if (event.events & EPOLLIN) {
-				int ioSize = 0;
+		// Queue   eventfd  .
+		int eventCnt = pWorker->event_Queue.popBatch(eventBatch, MAX_EVENTS);
+		for (int i = 0; i < eventCnt; i++) {
+			if (eventBatch[i].events & EPOLL_CLOSE_REQUEST) {
+				// Ÿ̸ ( )    û
+				ClosePlayer(eventBatch[i].data.u64);
+				continue;
+			}
+			EventProcessing(eventBatch[i]);
+		}
+		pWorker->eventCnt.fetch_add(eventCnt, std::memory_order_relaxed);
+	}
+}
+
+void Epoll_Server::EventProcessing(struct epoll_event &event)
+{
+	//  
+	auto pPlayerSession = getSessionByNo(event.data.fd);
+	if (pPlayerSession == nullptr) return;
+	if (event.events & EPOLLOUT) {
+		//   :  ִ sendQueue  .
+		std::unique_lock<std::mutex> sendGuard(pPlayerSession->send_mutex());
+		if (!FlushSend(pPlayerSession)) {
+			sendGuard.unlock();
+			spdlog::info("[Disconnect] EPOLLOUT SOCKET : {}, errno : {} || [unique_no:{}]", (int)pPlayerSession->get_sock(), errno, (int)pPlayerSession->get_unique_no());
+			ClosePlayer(pPlayerSession->get_handle());
+			return;
+		}
+	}
+	if (event.events & EPOLLIN) {
+		// Edge Trigger : EAGAIN      о  ̺Ʈ ´.
+		auto& readBuffer = pPlayerSession->read_buffer();
+		while (true) {
+			int ioSize;
+			char* pShared = nullptr;
+			Chain_Buffer* pChain = pPlayerSession->get_chain();
+			if (pChain != nullptr) {
+				// MAX_SOCKBUF  ū Packet  ޴  :  ũ ŭ block  ٷ readv
+				struct iovec iov[CHAIN_MAX_IOV];
+				int iovCnt = pChain->prepare_iov(iov, CHAIN_MAX_IOV);
 				errno = 0;	// Errno Clear
-				if (pPlayerSession->get_remainSize() > 0) {
-					pPlayerSession->read_buffer().checkWrite(pPlayerSession->get_remainSize());
+				ioSize = readv(pPlayerSession->get_sock(), iov, iovCnt);
+				if (ioSize > 0) {
+					chainReadCnt.fetch_add(1, std::memory_order_relaxed);
+					pChain->commit(ioSize);
+				}
+			}
+			else if (CS.get_shared_recv_buffer() && readBuffer.getReadAbleSize() == 0) {
+				//    Thread  Buffer  ޴´. ( Buffer   ʴ´)
+				pShared = getSharedRecvBuffer();
+				errno = 0;	// Errno Clear
+				ioSize = read(pPlayerSession->get_sock(), pShared, SHARED_RECV_SIZE);
+			}
+			else {
+				//   ϸ  ͸  . (mirror Buffer   ʴ´)
+				readBuffer.checkWrite(MIN_SOCKBUF);
+				if (readBuffer.getWriteAbleSize() <= 0) {
+					spdlog::error("ReadBuffer Over Flow || [unique_no:{}]", pPlayerSession->get_unique_no());
+					ClosePlayer(pPlayerSession->get_handle());
+					return;
 				}
 
-				/*spdlog::info("readPos : {}, writePos : {}, ReadAbleSize : {}",
-					pPlayerSession->read_buffer().getReadPos(), pPlayerSession->read_buffer().getWritePos(),
-					pPlayerSession->read_buffer().getReadAbleSize());*/
-
-				ioSize = read(pPlayerSession->get_sock(), pPlayerSession->read_buffer().getWriteBuffer(), pPlayerSession->read_buffer().getWriteAbleSize());
-				if (errno == CONNECTION_RESET) {
-					spdlog::info("[Disconnect] EPOLLIN SOCKET : {}, errno : {} || [unique_no:{}]", (int)pPlayerSession->get_sock(), errno, (int)pPlayerSession->get_unique_no());
-					ClosePlayer(pPlayerSession->get_sock(), &event);
-					continue;
-				}else if (ioSize == 0) {
-					spdlog::info("[Disconnect] EPOLLIN SOCKET : {}, ioSize : {} || [unique_no:{}]", (int)pPlayerSession->get_sock(), ioSize, (int)pPlayerSession->get_unique_no());
-					ClosePlayer(pPlayerSession->get_sock(), &event);
+				errno = 0;	// Errno Clear
+				ioSize = read(pPlayerSession->get_sock(), readBuffer.getWriteBuffer(), readBuffer.getWriteAbleSize());
+			}
+			if (ioSize > 0) {
+				// Recv ó (߸ Packet ̸  ´)
+				bool recvOk;
+				if (pChain != nullptr) {
+					recvOk = OnRecvChain(pPlayerSession);
 				}
-				else if (ioSize < 0) {
-					// Read Error
-					if (errno != EAGAIN) {
-						// Try again
-						spdlog::error("[Exception WorkerThread()] Read Error ioSize : {}, Error : {}, events : {} || [unique_no:{}]",
-							ioSize, errno, event.events, pPlayerSession->get_unique_no());
-					}
+				else if (pShared != nullptr) {
+					recvOk = OnRecvShared(pPlayerSession, pShared, ioSize);
 				}
 				else {
-					// Recv ó
-					//spdlog::info("ioSize : {}", ioSize);
-					OnRecv(event.data.fd, ioSize);
+					recvOk = OnRecv(event.data.fd, ioSize);
+				}
+				if (!recvOk) {
+					ClosePlayer(pPlayerSession->get_handle());
+					return;
 				}
+				//  ߴ :  ʹ Ŀ ۿ ΰ 簳   д´.
+				if (pPlayerSession->get_readPaused()) {
+					break;
+				}
+				continue;
+			}
+			else if (ioSize == 0) {
+				spdlog::info("[Disconnect] EPOLLIN SOCKET : {}, ioSize : {} || [unique_no:{}]", (int)pPlayerSession->get_sock(), ioSize, (int)pPlayerSession->get_unique_no());
+				ClosePlayer(pPlayerSession->get_handle());
+				return;
+			}
+			else if (errno == EINTR) {
+				continue;
 			}
-			else if (event.events & EPOLLERR) {
-				spdlog::info("[Disconnect] EPOLLERR SOCKET : {} || [unique_no:{}]", (int)pPlayerSession->get_sock(), (int)pPlayerSession->get_unique_no());
-				ClosePlayer(pPlayerSession->get_sock(), &event);
+			else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+				//  о.
+				break;
 			}
-			else  if (event.events & EPOLLOUT) {
-				// sendIO
+			else if (errno == CONNECTION_RESET) {
+				spdlog::info("[Disconnect] EPOLLIN SOCKET : {}, errno : {} || [unique_no:{}]", (int)pPlayerSession->get_sock(), errno, (int)pPlayerSession->get_unique_no());
 			}
-			else if (event.events & EPOLLRDHUP) {
-				spdlog::info("[Disconnect] EPOLLRDHUP SOCKET : {} || [unique_no:{}]", (int)pPlayerSession->get_sock(), (int)pPlayerSession->get_unique_no());
-				ClosePlayer(pPlayerSession->get_sock(), &event);
-			}else {
-				spdlog::error("[Exception WorkerThread()] No Event ({}), Error : {} || [unique_no:{}]",
-					ev.events, errno, pPlayerSession->get_unique_no());
+			else {
+				spdlog::error("[Exception WorkerThread()] Read Error ioSize : {}, Error : {}, events : {} || [unique_no:{}]",
+					ioSize, errno, event.events, pPlayerSession->get_unique_no());
 			}
+			ClosePlayer(pPlayerSession->get_handle());
+			return;
+		}
+		//   Buffer  Pool  ش. (ϼ  Packet     ִ´)
+		readBuffer.releaseIfEmpty();
+	}
+	else if (event.events & EPOLLERR) {
+		spdlog::info("[Disconnect] EPOLLERR SOCKET : {} || [unique_no:{}]", (int)pPlayerSession->get_sock(), (int)pPlayerSession->get_unique_no());
+		ClosePlayer(pPlayerSession->get_handle());
+	}
+	else  if (event.events & EPOLLOUT) {
+		// sendIO ( ó)
+	}
+	else if (event.events & EPOLLRDHUP) {
+		spdlog::info("[Disconnect] EPOLLRDHUP SOCKET : {} || [unique_no:{}]", (int)pPlayerSession->get_sock(), (int)pPlayerSession->get_unique_no());
+		ClosePlayer(pPlayerSession->get_handle());
+	}else {
+		spdlog::error("[Exception WorkerThread()] No Event ({}), Error : {} || [unique_no:{}]",
+			event.events, errno, pPlayerSession->get_unique_no());
+	}
+}
+
+void Epoll_Server::TimerProcessing(const Timer_Event &t)
+{
+	// EventThread  ȣ ǹǷ  ɸ ó Logic_API  ѱ.
+	switch (t.event) {
+	case T_NormalTime:
+	{
+		// ֱ ̺Ʈ
+	}
+	break;
+
+	case T_IdleCheck:
+	{
+		IdleCheck(t.handle);
+	}
+	break;
+
+	default:
+	{
+		spdlog::critical("[Exception TimerProcessing({})] No value defined..! || [handle:{}]", (int)t.event, t.handle);
+	}
+	break;
+	}
+}
+
+void Epoll_Server::IdleCheck(const session_handle handle)
+{
+	// ̹   Ÿ̸ ̴.
+	auto pPlayerSession = getSessionByHandle(handle);
+	if (pPlayerSession == nullptr) return;
+
+	unsigned_int64 now = timer.get_tick();
+	unsigned_int64 lastActive = pPlayerSession->get_last_active();
+	unsigned_int64 idleTick = now > lastActive ? now - lastActive : 0;
+	unsigned_int64 timeoutTick = (unsigned_int64)CS.get_idle_timeout_sec() * 1000 / TIMER_TICK_MS;
+	unsigned_int64 pingTick = (unsigned_int64)CS.get_ping_interval_sec() * 1000 / TIMER_TICK_MS;
+
+	if (idleTick >= timeoutTick) {
+		spdlog::info("[Disconnect] IDLE SOCKET : {}, idle : {}ms || [unique_no:{}]",
+			(int)pPlayerSession->get_sock(), idleTick * TIMER_TICK_MS, pPlayerSession->get_unique_no());
+		pPlayerSession->set_idle_timer(INVALID_TIMER_ID);
+		if (RequestClose(pPlayerSession, handle)) {
+			idleCloseCnt.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		//  û Queue   á. ( tick    )  tick  ٽ ûѴ.
+		Timer_Event t;
+		t.handle = handle;
+		t.event = T_IdleCheck;
+		pPlayerSession->set_idle_timer(timer.setTimerEvent(t, TIMER_TICK_MS));
+		return;
+	}
+
+	//  ̿  ־    ٽ Ѵ.
+	unsigned_int64 nextTick = timeoutTick - idleTick;
+	if (pingTick > 0) {
+		if (idleTick >= pingTick) {
+			//     з    ִ.
+			sc_packet_ping packet;
+			packet.packet_type = SERVER_AUTH_PING;
+			packet.packet_len = sizeof(packet);
+			packet.server_tick = now;
+			SendPacket(handle, reinterpret_cast<char *>(&packet), sizeof(packet));
+			pingCnt.fetch_add(1, std::memory_order_relaxed);
+			nextTick = std::min(nextTick, pingTick);
 		}
 		else {
-			std::this_thread::sleep_for(std::chrono::milliseconds(2));
+			nextTick = std::min(nextTick, pingTick - idleTick);
 		}
 	}
+
+	Timer_Event t;
+	t.handle = handle;
+	t.event = T_IdleCheck;
+	pPlayerSession->set_idle_timer(timer.setTimerEvent(t, (int)(nextTick * TIMER_TICK_MS)));
 }
 
-void Epoll_Server::ClosePlayer(const int sock, struct epoll_event *ev)
+void Epoll_Server::ClosePlayer(const session_handle handle)
 {
-	epoll_ctl(epfd, EPOLL_CTL_DEL, sock, ev);
-	player_session.erase(sock);
-	player.erase(sock);
+	int sock = -1;
+	{
+		std::lock_guard<std::mutex> guard(mSessionLock);
+		// ̹  ڵ ̴. fd  ٸ     Ƿ ƹ͵  ʴ´.
+		auto pPlayerSession = mSessionPool->find_handle(handle);
+		if (pPlayerSession == nullptr) {
+			return;
+		}
+		sock = pPlayerSession->get_sock();
+		int reactorNo = pPlayerSession->get_reactor_no();
+		if (reactorNo == URING_REACTOR_NO) {
+			//  multishot recv  .
+			shutdown(sock, SHUT_RDWR);
+		}
+		else {
+			epoll_ctl(get_epfd(reactorNo), EPOLL_CTL_DEL, sock, NULL);
+		}
+		{
+			//   Packet  .
+			std::lock_guard<std::mutex> sendGuard(pPlayerSession->send_mutex());
+			pPlayerSession->clear_sendQueue();
+			if (pPlayerSession->get_readPaused()) {
+				pPlayerSession->set_readPaused(false);
+				pausedSessionCnt.fetch_sub(1, std::memory_order_relaxed);
+			}
+			// ֺ  ȸ  .
+			aoi.leave(pPlayerSession->get_slot_no());
+			//  ˻ Ÿ̸Ӹ . (̹    ȴ)
+			timer.cancelTimerEvent(pPlayerSession->get_idle_timer());
+			pPlayerSession->set_idle_timer(INVALID_TIMER_ID);
+			// α    ӽ uniqueNo  ش.
+			if (pPlayerSession->get_unique_no() < UNIQUE_START_NO) {
+				tempUniqueNo.push(pPlayerSession->get_unique_no());
+			}
+		}
+		// ޴  Packet  Buffer, block  ٷ Pool  ش. (  I/O Thread  ȣ ȴ)
+		pPlayerSession->read_buffer().clear();
+		pPlayerSession->end_chain();
+		// slot  ݳϿ  ӿ  Ѵ.
+		if (mSessionPool->release(sock) && reactorNo >= 0) {
+			mReactors[reactorNo]->decr_session_cnt();
+		}
+	}
 	close(sock);
 }
 
-bool Epoll_Server::AcceptProcessing(struct epoll_event &ev)
+bool Epoll_Server::RequestClose(PLAYER_Session * pPlayerSession, const session_handle handle)
 {
-	// ű   ó
-	PLAYER_Session* pPlayerSession = new PLAYER_Session;
-	pPlayerSession->set_init_session();
+	// ReadBuffer (No_Lock), epoll , fd ݳ   I/O Thread  ٲ۴.
+	int reactorNo = pPlayerSession->get_reactor_no();
+	if (reactorNo == URING_REACTOR_NO) {
+		// io_uring  Ÿ̸Ӵ Engine Thread   ȴ.
+		ClosePlayer(handle);
+	}
+	else if (reactorNo >= 0) {
+		return mReactors[reactorNo]->requestClose(handle);
+	}
+	else {
+		// EventThread   Ģ (fd % WORKER_CNT)  Worker  .
+		struct epoll_event closeEv;
+		memset(&closeEv, 0, sizeof closeEv);
+		closeEv.events = EPOLL_CLOSE_REQUEST;
+		closeEv.data.u64 = handle;
+		mWorkers[pPlayerSession->get_sock() % mWorkers.size()]->event_Queue.push(closeEv);
+	}
+	return true;
+}
 
-	struct sockaddr_in client_addr;
-	socklen_t client_addr_len = sizeof client_addr;
+bool Epoll_Server::AcceptProcessing(const int listenSock, const int reactorNo)
+{
+	// ű   ó :  ť    ѹ ޴´.
+	acceptWakeCnt.fetch_add(1, std::memory_order_relaxed);
+	bool accepted = false;
+	while (true) {
+		struct sockaddr_in client_addr;
+		socklen_t client_addr_len = sizeof client_addr;
 
-	pPlayerSession->get_sock() = accept(sock, (struct sockaddr *) &client_addr, &client_addr_len);
-	if (pPlayerSession->get_sock() < 0) {
-		//   ƴϴ.
-		return false;
+		int clientSock = accept4(listenSock, (struct sockaddr *) &client_addr, &client_addr_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (clientSock < 0) {
+			if (errno == EINTR || errno == ECONNABORTED) {
+				//  ߿   ǳʶڴ.
+				continue;
+			}
+			if (errno != EAGAIN && errno != EWOULDBLOCK) {
+				// EMFILE, ENFILE ...
+				spdlog::error("accept4() Function failure : {}", strerror(errno));
+			}
+			break;
+		}
+		if (CS.get_wait_strategy() == WAIT_BUSY_POLL) {
+			SetBusyPoll(clientSock);
+		}
+		if (RegisterSession(clientSock, client_addr, reactorNo)) {
+			accepted = true;
+		}
+	}
+	return accepted;
+}
+
+void Epoll_Server::SetBusyPoll(const int sock)
+{
+	// net.core.busy_read  ū  CAP_NET_ADMIN  ʿϴ. (д ѹ )
+	static std::atomic<bool> failLogged{ false };
+	int usec = CS.get_busy_poll_usec();
+	if (usec > 0 && setsockopt(sock, SOL_SOCKET, SO_BUSY_POLL, &usec, sizeof usec) < 0 && !failLogged.exchange(true)) {
+		spdlog::error("setsockopt(SO_BUSY_POLL) Function failure : {}", strerror(errno));
 	}
-	else if (player_session.size() >= CS.get_max_player()) {
-		spdlog::critical("Client Full..! sessionSize({}) >= MAX_PLAYER({})", player_session.size(), CS.get_max_player());
-		ClosePlayer(pPlayerSession->get_sock(), &ev);
+}
+
+bool Epoll_Server::RegisterSession(const int clientSock, struct sockaddr_in &client_addr, const int reactorNo)
+{
+	std::unique_lock<std::mutex> sessionGuard(mSessionLock);
+	if (mSessionPool->get_use_cnt() >= mSessionPool->get_max_cnt()) {
+		spdlog::critical("Client Full..! sessionSize({}) >= MAX_PLAYER({})", mSessionPool->get_use_cnt(), mSessionPool->get_max_cnt());
+		sessionGuard.unlock();
+		close(clientSock);
 		return false;
 	}
 
 	// ӽ uniqueNo     ´.
 	if (tempUniqueNo.size() == 0) {
 		spdlog::critical("tempUniqueNo Full..!");
-		ClosePlayer(pPlayerSession->get_sock(), &ev);
+		sessionGuard.unlock();
+		close(clientSock);
+		return false;
+	}
+
+	// ̸    / ÷̾ fd   Ѵ.
+	PLAYER_Session* pPlayerSession = mSessionPool->alloc(clientSock);
+	if (pPlayerSession == nullptr) {
+		sessionGuard.unlock();
+		close(clientSock);
 		return false;
 	}
 
 	// session set ش.
 	pPlayerSession->set_unique_no(tempUniqueNo.front());
-
-	// player_session ߰ Ѵ.
-	player_session.insert(std::unordered_map<int, class PLAYER_Session *>::value_type(pPlayerSession->get_sock(), pPlayerSession));
+	pPlayerSession->set_reactor_no(reactorNo);
 
 	// ÷̾ set ش.
-	class PLAYER * acceptPlayer = new class PLAYER;
-	acceptPlayer->set_sock(pPlayerSession->get_sock());
-	acceptPlayer->set_unique_no(tempUniqueNo.front());
-	player.insert(std::unordered_map<int, class PLAYER *>::value_type(pPlayerSession->get_sock(), acceptPlayer));
+	mSessionPool->find_player(clientSock)->set_unique_no(tempUniqueNo.front());
 
 	//Ŭ̾Ʈ  
 	tempUniqueNo.pop();
+	sessionGuard.unlock();
+
+	StartIdleCheck(pPlayerSession);
 
 	// fd  غ ó
-	SetNonBlocking(pPlayerSession->get_sock());
+	AddEpollSession(pPlayerSession->get_sock(), reactorNo);
+	acceptCnt.fetch_add(1, std::memory_order_relaxed);
 
 	char clientIP[32] = { 0, };
 	inet_ntop(AF_INET, &(client_addr.sin_addr), clientIP, 32 - 1);
-	spdlog::info("[Connect] Client IP : {} / SOCKET : {} || [unique_no:{}]", clientIP, (int)pPlayerSession->get_sock(), pPlayerSession->get_unique_no());
+	if (reactorNo >= 0) {
+		mReactors[reactorNo]->incr_session_cnt();
+		spdlog::info("[Connect] Client IP : {} / SOCKET : {} / Reactor : {} (sessions : {}) || [unique_no:{}]",
+			clientIP, (int)pPlayerSession->get_sock(), reactorNo, mReactors[reactorNo]->get_session_cnt(), pPlayerSession->get_unique_no());
+	}
+	else {
+		spdlog::info("[Connect] Client IP : {} / SOCKET : {} || [unique_no:{}]", clientIP, (int)pPlayerSession->get_sock(), pPlayerSession->get_unique_no());
+	}
+	return true;
+}
+
+bool Epoll_Server::RestoreSession(const int clientSock, const unsigned_int64 uniqueNo, const std::string &readData, const std::string &sendData)
+{
+	//  μ Reactor ġ     ٽ .
+	int reactorNo = -1;
+	if (mUringEngine != nullptr) {
+		reactorNo = URING_REACTOR_NO;
+	}
+	else if (!mReactors.empty()) {
+		reactorNo = clientSock % (int)mReactors.size();
+	}
+	if (CS.get_wait_strategy() == WAIT_BUSY_POLL) {
+		SetBusyPoll(clientSock);
+	}
+
+	std::unique_lock<std::mutex> sessionGuard(mSessionLock);
+	// α   ӽ uniqueNo   ޴´.
+	if (mSessionPool->get_use_cnt() >= mSessionPool->get_max_cnt() || (uniqueNo < UNIQUE_START_NO && tempUniqueNo.size() == 0)) {
+		spdlog::critical("[HotRestart] Client Full..! sessionSize({}) || [unique_no:{}]", mSessionPool->get_use_cnt(), uniqueNo);
+		sessionGuard.unlock();
+		close(clientSock);
+		return false;
+	}
+	PLAYER_Session* pPlayerSession = mSessionPool->alloc(clientSock);
+	if (pPlayerSession == nullptr) {
+		sessionGuard.unlock();
+		close(clientSock);
+		return false;
+	}
+	unsigned_int64 sessionUniqueNo = uniqueNo;
+	if (uniqueNo < UNIQUE_START_NO) {
+		sessionUniqueNo = tempUniqueNo.front();
+		tempUniqueNo.pop();
+	}
+	pPlayerSession->set_unique_no(sessionUniqueNo);
+	pPlayerSession->set_reactor_no(reactorNo);
+	mSessionPool->find_player(clientSock)->set_unique_no(sessionUniqueNo);
+	sessionGuard.unlock();
+
+	// ϼ  Packet  ǵ. (ū Packet  Chain_Buffer )
+	bool restoreOk = true;
+	if (!readData.empty()) {
+		PACKET_HEADER header;
+		memset(&header, 0, sizeof(header));
+		if (readData.size() >= PACKET_HEADER_BYTE) {
+			memcpy(&header, readData.data(), sizeof(header));
+		}
+		if (header.packet_len > MAX_SOCKBUF && (int)readData.size() < header.packet_len) {
+			pPlayerSession->begin_chain(header.packet_len)->append(readData.data(), (int)readData.size());
+		}
+		else {
+			restoreOk = pPlayerSession->read_buffer().setWriteBuffer(const_cast<char *>(readData.data()), (int)readData.size()) >= 0;
+		}
+	}
+	StartIdleCheck(pPlayerSession);
+
+	if (reactorNo == URING_REACTOR_NO) {
+		mUringEngine->requestRecvCtl(pPlayerSession->get_handle(), false);
+	}
+	else {
+		AddEpollSession(clientSock, reactorNo);
+		if (reactorNo >= 0) {
+			mReactors[reactorNo]->incr_session_cnt();
+		}
+	}
+	//   ǵ ϸ Packet 谡 Ƿ   (  ) ٷ ´.
+	if (!restoreOk) {
+		spdlog::critical("[HotRestart] Restore read buffer failure ({} byte) || [unique_no:{}]", readData.size(), sessionUniqueNo);
+		ClosePlayer(pPlayerSession->get_handle());
+		return false;
+	}
+
+	//  μ   ͸ ̾ .
+	if (!sendData.empty()) {
+		std::lock_guard<std::mutex> sendGuard(pPlayerSession->send_mutex());
+		pPlayerSession->sendReady(const_cast<char *>(sendData.data()), (int)sendData.size());
+		FlushSend(pPlayerSession);
+	}
+	spdlog::info("[HotRestart] Restore SOCKET : {}, read : {}, send : {} || [unique_no:{}]",
+		clientSock, readData.size(), sendData.size(), sessionUniqueNo);
 	return true;
 }
 
-void Epoll_Server::OnRecv(const int sock, const int ioSize)
+void Epoll_Server::StartIdleCheck(PLAYER_Session * pPlayerSession)
+{
+	//  ˻ IDLE_TIMEOUT_SEC ڿ ó  Ѵ. (ping  ϸ PING_INTERVAL_SEC)
+	pPlayerSession->set_last_active(timer.get_tick());
+	if (CS.get_idle_timeout_sec() > 0) {
+		Timer_Event t;
+		t.handle = pPlayerSession->get_handle();
+		t.event = T_IdleCheck;
+		int checkSec = CS.get_ping_interval_sec() > 0 ? CS.get_ping_interval_sec() : CS.get_idle_timeout_sec();
+		pPlayerSession->set_idle_timer(timer.setTimerEvent(t, checkSec * 1000));
+	}
+}
+
+bool Epoll_Server::OnRecv(const int sock, const int ioSize)
 {
 	auto pPlayerSession = getSessionByNo(sock);
+	if (pPlayerSession == nullptr) return false;
+	auto& readBuffer = pPlayerSession->read_buffer();
+
+	//  ˻   ð (tick   1ȸ)
+	pPlayerSession->set_last_active(timer.get_tick());
 
 	// ⸦  ġ Űش.
-	if (!pPlayerSession->read_buffer().moveWritePos(ioSize))
+	if (!readBuffer.moveWritePos(ioSize))
 	{
 		spdlog::error("ReadBuffer Over Flow || [unique_no:{}]", pPlayerSession->get_unique_no());
+		return false;
 	}
 
-	PACKET_HEADER header;
-	pPlayerSession->set_remainSize(0);
-	while (pPlayerSession->read_buffer().getReadAbleSize() > 0) {
-
-		//   ִ Packet ũⰡ Header Packet    ó Ѵ.
-		if (pPlayerSession->read_buffer().getReadAbleSize() <= sizeof(header)) {
+	// ReadBuffer  ѹ Ⱦ ϼ Packet   API ̺귯 ѹ  Ѵ.
+	FRAME_View frames[MAX_FRAME_BATCH];
+	while (readBuffer.getReadAbleSize() >= PACKET_HEADER_BYTE) {
+		int readSize = 0;
+		int frameCnt = PacketDecoder::decode(readBuffer.getReadBuffer(), readBuffer.getReadAbleSize(), frames, MAX_FRAME_BATCH, readSize);
+		if (frameCnt == DECODE_ERROR) {
+			// ߸ Header Ĵ Packet 踦   .
+			PACKET_HEADER header;
+			memcpy(&header, readBuffer.getReadBuffer(), sizeof(header));
+			spdlog::critical("Packet Header Critical type({}) len({}) minSize({}) || [unique_no:{}]",
+				header.packet_type, header.packet_len, PacketDecoder::getMinSize(header.packet_type), pPlayerSession->get_unique_no());
+			pPlayerSession->update_error_cnt();
+			return false;
+		}
+		if (frameCnt == 0) {
+			//    ߴ.
 			break;
 		}
+		pPlayerSession->add_queued_frames(frameCnt);
+		api.packet_AddBatch(pPlayerSession->get_handle(), sock, pPlayerSession->get_unique_no(), frames, frameCnt);
 
-		// Packet_Header  ´.
-		auto PacketSize = pPlayerSession->read_buffer().getHeaderSize((char*)&header, sizeof(header));
-		if (PacketSize == -1) {
-			spdlog::error("getHeaderSize || [unique_no:{}]", pPlayerSession->get_unique_no());
-		}
+		// б Ϸ ó
+		readBuffer.moveReadPos(readSize);
+	}
 
-		if (pPlayerSession->read_buffer().getReadAbleSize() < header.packet_len || header.packet_len <= PACKET_HEADER_BYTE) {
-			//   ִ Packet  ۵ Packet ü    ó Ѵ.
-			spdlog::critical("Packet Header Critical AbleSize({}) <= PacketSize({}) OR getReadAbleSize({}) < PacketSize({}) || [unique_no:{}]",
-				header.packet_len, PACKET_HEADER_BYTE, pPlayerSession->read_buffer().getReadAbleSize(), header.packet_len, pPlayerSession->get_unique_no());
-			// Packet  Header ũ⺸   Error count ø.
-			if (header.packet_len <= PACKET_HEADER_BYTE) {
-				pPlayerSession->update_error_cnt();
-			}
-			break;
+	// MAX_SOCKBUF  ū Packet :  պκ Chain_Buffer  ű  block  ٷ ޴´.
+	// (decode  ũ⸦ ˻ Ͽ, ReadBuffer   ʹ   Packet ̴)
+	if (readBuffer.getReadAbleSize() >= PACKET_HEADER_BYTE) {
+		PACKET_HEADER header;
+		memcpy(&header, readBuffer.getReadBuffer(), sizeof(header));
+		if (header.packet_len > MAX_SOCKBUF) {
+			Chain_Buffer* pChain = pPlayerSession->begin_chain(header.packet_len);
+			int copySize = pChain->append(readBuffer.getReadBuffer(), readBuffer.getReadAbleSize());
+			readBuffer.moveReadPos(copySize);
+			return OnRecvChain(pPlayerSession);
 		}
-		else {
-			//  ó ϴ ġ
+	}
 
-			// API ̺귯 ش    ش.
-			ProtocolType protocolBase = (ProtocolType)((int)header.packet_type / (int)PACKET_RANG_SIZE * (int)PACKET_RANG_SIZE);
+	// ó /  Ⱑ HIGH WATER    .
+	if (!pPlayerSession->get_readPaused()) {
+		std::lock_guard<std::mutex> sendGuard(pPlayerSession->send_mutex());
+		UpdateBackpressure(pPlayerSession);
+	}
+	return true;
+}
 
-			/*spdlog::info("uniqueNo : {}, packet Size : {}, protocolBase : {}, protocolType : {}", 
-				pPlayerSession->get_unique_no(), header.packet_len, protocolBase, header.packet_type);*/
-			api.packet_Add(sock, pPlayerSession->get_unique_no(), pPlayerSession->read_buffer().getReadBuffer(), header.packet_len);
+bool Epoll_Server::OnRecvShared(PLAYER_Session * pPlayerSession, char * pData, const int ioSize)
+{
+	//  ˻   ð
+	pPlayerSession->set_last_active(timer.get_tick());
+	sharedRecvCnt.fetch_add(1, std::memory_order_relaxed);
 
-			// б Ϸ ó
-			pPlayerSession->read_buffer().moveReadPos(header.packet_len);
-			pPlayerSession->incr_remainSize((ioSize - header.packet_len));
+	// ϼ Packet   Buffer  ٷ Logic_API  ѱ. (packet_AddBatch  )
+	FRAME_View frames[MAX_FRAME_BATCH];
+	int offset = 0;
+	while (offset < ioSize) {
+		Chain_Buffer* pChain = pPlayerSession->get_chain();
+		if (pChain != nullptr) {
+			// MAX_SOCKBUF  ū Packet : Packet   block  Ѵ.
+			offset += pChain->append(pData + offset, ioSize - offset);
+			if (!OnRecvChain(pPlayerSession)) {
+				return false;
+			}
+			continue;
+		}
+		int readSize = 0;
+		int frameCnt = PacketDecoder::decode(pData + offset, ioSize - offset, frames, MAX_FRAME_BATCH, readSize);
+		if (frameCnt == DECODE_ERROR) {
+			PACKET_HEADER header;
+			memcpy(&header, pData + offset, sizeof(header));
+			spdlog::critical("Packet Header Critical type({}) len({}) minSize({}) || [unique_no:{}]",
+				header.packet_type, header.packet_len, PacketDecoder::getMinSize(header.packet_type), pPlayerSession->get_unique_no());
+			pPlayerSession->update_error_cnt();
+			return false;
+		}
+		if (frameCnt > 0) {
+			pPlayerSession->add_queued_frames(frameCnt);
+			api.packet_AddBatch(pPlayerSession->get_handle(), pPlayerSession->get_sock(), pPlayerSession->get_unique_no(), frames, frameCnt);
+			offset += readSize;
+			continue;
+		}
+		// ū Packet  Header ̸ Chain_Buffer   ̾ Ѵ.
+		if (ioSize - offset >= PACKET_HEADER_BYTE) {
+			PACKET_HEADER header;
+			memcpy(&header, pData + offset, sizeof(header));
+			if (header.packet_len > MAX_SOCKBUF) {
+				pPlayerSession->begin_chain(header.packet_len);
+				continue;
+			}
 		}
+		//    ߴ.
+		break;
+	}
+
+	// ϼ  ޺κи  Buffer  ű. (MAX_SOCKBUF  ۴)
+	if (offset < ioSize) {
+		if (pPlayerSession->read_buffer().setWriteBuffer(pData + offset, ioSize - offset) < 0) {
+			spdlog::error("ReadBuffer carryover failure ({} byte) || [unique_no:{}]", ioSize - offset, pPlayerSession->get_unique_no());
+			return false;
+		}
+		carryoverCnt.fetch_add(1, std::memory_order_relaxed);
+		carryoverBytes.fetch_add(ioSize - offset, std::memory_order_relaxed);
+	}
+
+	// ó /  Ⱑ HIGH WATER    .
+	if (!pPlayerSession->get_readPaused()) {
+		std::lock_guard<std::mutex> sendGuard(pPlayerSession->send_mutex());
+		UpdateBackpressure(pPlayerSession);
+	}
+	return true;
+}
 
+bool Epoll_Server::OnRecvChain(PLAYER_Session * pPlayerSession)
+{
+	//  ˻   ð
+	pPlayerSession->set_last_active(timer.get_tick());
 
+	Chain_Buffer* pChain = pPlayerSession->get_chain();
+	if (pChain == nullptr || !pChain->is_complete()) {
+		//    ߴ.
+		return true;
 	}
 
+	// block  Packet ϳ ̾ ٿ ѱ, block  Pool  ش.
+	pPlayerSession->add_queued_frames(1);
+	api.packet_AddChain(pPlayerSession->get_handle(), pPlayerSession->get_sock(), pPlayerSession->get_unique_no(), *pChain);
+	pPlayerSession->end_chain();
+	chainFrameCnt.fetch_add(1, std::memory_order_relaxed);
+
+	// ó /  Ⱑ HIGH WATER    .
+	if (!pPlayerSession->get_readPaused()) {
+		std::lock_guard<std::mutex> sendGuard(pPlayerSession->send_mutex());
+		UpdateBackpressure(pPlayerSession);
+	}
+	return true;
 }
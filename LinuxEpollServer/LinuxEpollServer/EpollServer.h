@@ -7,44 +7,131 @@
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <errno.h>
+#include <chrono>
 #define MAX_EVENTS 256			// Ǵ ִ  
-#define BACKLOG 10				//   ť
+#define BACKLOG 1024			//   ť ⺻ (LISTEN_BACKLOG)
 #define CONNECTION_RESET 104	// Ŭ̾Ʈ   Ǿ.
+#define MAX_WORKER_QUEUE 16384	// WorkerThread  event Queue ũ
+#define URING_REACTOR_NO -2		// io_uring   reactor_no
+#define EPOLL_CLOSE_REQUEST (1u << 24)	// Worker event_Queue     û (Ŀ  ʴ bit, data.u64 = ڵ)
+#define BROADCAST_BENCH_SIZE 512	// ܼ 'b' Է½ benchmark Packet ũ
+#define SHARED_RECV_SIZE (64 * 1024)	// Thread   Buffer ũ (SHARED_RECV_BUFFER)
+
+struct Timer_Event;
 
 
 class Epoll_Server {
+	friend class Uring_Engine;
+	friend class Epoll_Reactor;
 public:
 	Epoll_Server();
 	~Epoll_Server();
 	void init_server();
 	void BindandListen(int port);
 	void add_tempUniqueNo(unsigned_int64 uniqueNo);								//  uniqueNo ٽ 
-	bool SendPacket(int sock, char* pMsg, int nLen);							// Packet Send ó Ѵ.
-	class PLAYER_Session * getSessionByNo(int socketNo);						// PlayerSession 
+	bool ChangeUniqueNo(const session_handle handle, const unsigned_int64 uniqueNo);	// α : ӽ uniqueNo  ٲٰ ݳ ( ڵ false)
+	bool SendPacket(session_handle handle, char* pMsg, int nLen);				// Packet sendQueue ִ´.
+	int BroadcastPacket(const session_handle* handles, const int handleCnt, char* pMsg, int nLen);	// ѹ  Packet    sendQueue   ִ´.
+	static void benchmarkBroadcast(const int recipientCnt, const int packetSize);	// SendPacket  İ Broadcast 
+	static void benchmarkRecv(const int sessionCnt, const int packetSize, const int recvSize);	//  Buffer Ű Thread  Buffer  
+	void FlushSendAll();														// SendPacket  ǵ ѹ Ѵ.
+	class PLAYER_Session * getSessionByNo(int socketNo);						// PlayerSession  (I/O Thread)
+	class PLAYER_Session * getSessionByHandle(session_handle handle);			// PlayerSession  ( ڵ nullptr)
+	class PLAYER * getPlayerByHandle(session_handle handle);					// Player 
+	std::mutex& get_session_mutex() { return mSessionLock; }					// Session_Pool, tempUniqueNo Lock
+	bool ListenSocket(const int listenSock);									// TCP_DEFER_ACCEPT, listen(LISTEN_BACKLOG)
+	bool AcceptProcessing(const int listenSock, const int reactorNo);			// EAGAIN  accept4
+	void SetBusyPoll(const int sock);											// SO_BUSY_POLL (WAIT_STRATEGY busy)
+	bool RegisterSession(const int clientSock, struct sockaddr_in &client_addr, const int reactorNo);	// accept    , 
+	bool RestoreSession(const int clientSock, const unsigned_int64 uniqueNo, const std::string &readData, const std::string &sendData);	// Hot Restart  Ѱ   
+	void EventProcessing(struct epoll_event &event);							// EPOLLIN, EPOLLERR ... ó
+	void TimerProcessing(const struct Timer_Event &t);							//  Ÿ̸ ó
+	void OnPacketDone(const session_handle handle);								// Logic_API ó Ϸ (ó   )
+	void logReactorStats();														// Reactor    
+	void logWorkerStats();														// Worker  ó event  
+	void logSendStats();														// Packet  send syscall ,  ڵ  
+	void logAcceptStats();														// ʴ accept  
+	void logIdleStats();														//   / ping  
+	void logBackpressureStats();												//  ߴ  ,   ⷮ 
+	void logChainStats();														// MAX_SOCKBUF  ū Packet  
+	void logMemoryStats();														// RSS,   RSS, Buffer_Pool 
+	void logRecvStats();														// Thread  Buffer ,     
+	static long long getRssKB();												//  RSS (/proc/self/statm)
+	void Shutdown(const int drainSec);											// ,  ߴ   ó / , Thread 
+	int get_shutdown_fd() { return shutdownFd; }								// I/O Thread  ˸ eventfd
+	void StopIoThreads();														// Event / Worker / Reactor / Uring Thread  (Listen  )
+	void ResumeIoThreads();														// StopIoThreads  ٽ  (Hot Restart )
+	std::vector<int> get_listen_socks();										//   Listen  (Hot Restart)
+	class PLAYER_Session * getSessionBySlot(const int slot);					//  slot   (Hot Restart)
+	int get_max_session();
 
 private:
 	int sock;
-	int epfd;															// size ŭ Ŀ   [fd_epoll]
+	int epfd;															// size ŭ Ŀ    [fd_epoll]
 	struct sockaddr_in sin;
 	struct epoll_event ev;
 	struct epoll_event events[MAX_EVENTS];
-	std::mutex	mLock;
-	std::queue<struct epoll_event> event_Queue;
+	std::mutex	mSessionLock;											// Session_Pool alloc / release, tempUniqueNo
+	class Session_Pool * mSessionPool;									// fd  ã  / ÷̾
+	struct WorkerContext {
+		LockFreeQueue<struct epoll_event> event_Queue{ MAX_WORKER_QUEUE };	// EventThread -> WorkerThread
+		std::atomic<unsigned_int64> eventCnt{ 0 };							// ó event 
+	};
+	std::vector<WorkerContext *> mWorkers;								// (fd)   Worker
+	std::atomic<unsigned_int64> sendPacketCnt;							// SendPacket 
+	std::atomic<unsigned_int64> sendCallCnt;							// sendmsg syscall 
+	std::atomic<unsigned_int64> staleHandleCnt;							//    SendPacket 
+	std::atomic<unsigned_int64> broadcastCnt;							// BroadcastPacket 
+	std::atomic<unsigned_int64> broadcastTargetCnt;						// BroadcastPacket    
+	std::atomic<unsigned_int64> idleCloseCnt;							//  ð ʰ   
+	std::atomic<unsigned_int64> pingCnt;								//  ping 
+	std::atomic<int> pausedSessionCnt;									//   ߴ  
+	std::atomic<unsigned_int64> readPauseCnt;							//  ߴ Ƚ ()
+	std::atomic<unsigned_int64> readResumeCnt;							//  簳 Ƚ ()
+	std::atomic<unsigned_int64> acceptCnt;								// ϵ   ()
+	std::atomic<unsigned_int64> acceptWakeCnt;							// Listen  ̺Ʈ 
+	std::atomic<unsigned_int64> chainFrameCnt;							// Chain_Buffer   ū Packet 
+	std::atomic<unsigned_int64> chainReadCnt;							// Chain_Buffer   readv 
+	std::atomic<unsigned_int64> sharedRecvCnt;							// Thread  Buffer   
+	std::atomic<unsigned_int64> carryoverCnt;							//    Buffer  ű 
+	std::atomic<unsigned_int64> carryoverBytes;							//    Buffer  ű byte
+	unsigned_int64 lastAcceptCnt;										// logAcceptStats   
+	long long baseRssKB;												//  Pool   RSS (  RSS )
+	std::chrono::steady_clock::time_point lastAcceptTime;
+	std::vector<class Epoll_Reactor *> mReactors;						// Reactor  (REACTOR_CNT > 0)
+	class Uring_Engine * mUringEngine;									// io_uring  (IO_ENGINE=uring)
+	int shutdownFd;														//  epoll  ,  ѹ write ( ʴ´)
+	bool mInheritListen;												// Hot Restart  Ѱ  Listen   (bind )
 
-	std::unordered_map<int, bool> disconnectUniqueNo;					//  UniqueNo
 	std::queue<unsigned_int64> tempUniqueNo;							// ӽ uniqueNo
 	bool mIsEventThreadRun;												// Event
 	std::thread	mEventThread;											// Event Thread
 	bool mIsWorkerThreadRun;											// Worker
 	std::vector<std::thread> mWorkerThreads;							// Worker Thread
-	void SetNonBlocking(int sock);
+	void init_epoll();													// epoll ( / Reactor) غ
+	void AddEpollSession(const int sock, const int reactorNo);			//   epoll 
+	int get_epfd(const int reactorNo);									//  ϵ epoll
+	void AddEventFd(const int targetEpfd, const int fd);				// timerfd, shutdownFd, Reactor wakeFd  epoll  
 	void EventThread();													// EventThread Function
-	void WorkerThread();												// WorkerThread Function
-	void ClosePlayer(const int sock, struct epoll_event *ev);			// User Close
-	bool AcceptProcessing(struct epoll_event &ev);						// Accept Processing
-	void OnRecv(const int sock, const int ioSize);						// Recv ó  Ѵ.
+	void WorkerThread(WorkerContext *pWorker);							// WorkerThread Function
+	void ClosePlayer(const session_handle handle);						// User Close (̹  ڵ ,  I/O Thread  ȣ)
+	bool RequestClose(class PLAYER_Session * pPlayerSession, const session_handle handle);	// ٸ Thread   I/O Thread   û (Queue    false)
+	bool OnRecv(const int sock, const int ioSize);						// Recv ó  Ѵ.
+	bool OnRecvChain(class PLAYER_Session * pPlayerSession);			// ū Packet   ޾ Logic_API  ѱ.
+	bool OnRecvShared(class PLAYER_Session * pPlayerSession, char* pData, const int ioSize);	//  Buffer  ٷ ,    Buffer  ű.
+	bool FlushSend(class PLAYER_Session * pPlayerSession);				// sendQueue , EPOLLOUT /
+	void MarkSendPending(class PLAYER_Session * pPlayerSession, session_handle handle);	// FlushSendAll    (send_mutex ʿ)
+	void ModEpollSession(class PLAYER_Session * pPlayerSession);		// readPaused, sendArmed  epoll ̺Ʈ  (send_mutex ʿ)
+	void UpdateBackpressure(class PLAYER_Session * pPlayerSession);		// HIGH / LOW WATER   ߴ, 簳 (send_mutex ʿ)
+	void IdleCheck(const session_handle handle);						//   , ping,  ˻ 
+	void CloseListenSockets();											// ű  ߴ
+	void StartIdleCheck(class PLAYER_Session * pPlayerSession);			//   ð , ù T_IdleCheck 
+	int DrainSendQueue(const std::chrono::steady_clock::time_point deadline);	//  sendQueue  (   )
+	int CloseAllSessions();												//    (  )
 };
 
 
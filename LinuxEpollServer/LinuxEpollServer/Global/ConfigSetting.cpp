@@ -19,6 +19,138 @@ void ConfigSetting::loadSettingData()
 	// LIMIT_ERROR_CNT
 	this->set_limit_err_cnt(reader.GetInteger("Common", "LIMIT_ERROR_CNT", 10));
 
+	// [Threads] REACTOR_CNT (이전 설정 파일은 [Common] 값을 사용한다)
+	this->set_reactor_cnt(reader.GetInteger("Threads", "REACTOR_CNT", reader.GetInteger("Common", "REACTOR_CNT", 0)));
+
+	// [Threads] WORKER_CNT
+	int workerCnt = reader.GetInteger("Threads", "WORKER_CNT", reader.GetInteger("Common", "WORKER_CNT", MAX_WORKERTHREAD));
+	if (workerCnt < 1) workerCnt = 1;
+	if (workerCnt > MAX_WORKERTHREAD) workerCnt = MAX_WORKERTHREAD;
+	this->set_worker_cnt(workerCnt);
+
+	// [Threads] LOGIC_CNT
+	int logicCnt = reader.GetInteger("Threads", "LOGIC_CNT", 1);
+	if (logicCnt < 1) logicCnt = 1;
+	if (logicCnt > MAX_LOGIC_CNT) logicCnt = MAX_LOGIC_CNT;
+	this->set_logic_cnt(logicCnt);
+
+	// [Threads] EVENT_CPU, WORKER_CPU, REACTOR_CPU, LOGIC_CPU, UDP_CPU, NUMA_NODE
+	this->set_thread_cpu(THREAD_EVENT, reader.Get("Threads", "EVENT_CPU", ""));
+	this->set_thread_cpu(THREAD_WORKER, reader.Get("Threads", "WORKER_CPU", ""));
+	this->set_thread_cpu(THREAD_REACTOR, reader.Get("Threads", "REACTOR_CPU", ""));
+	this->set_thread_cpu(THREAD_LOGIC, reader.Get("Threads", "LOGIC_CPU", ""));
+	this->set_thread_cpu(THREAD_UDP, reader.Get("Threads", "UDP_CPU", ""));
+	int numaNode = reader.GetInteger("Threads", "NUMA_NODE", -1);
+	if (numaNode < -1) numaNode = -1;
+	this->set_numa_node(numaNode);
+
+	// [Threads] WAIT_STRATEGY (block / spin / busy), SPIN_USEC, BUSY_POLL_USEC
+	std::string waitStrategy = reader.Get("Threads", "WAIT_STRATEGY", "block");
+	if (waitStrategy == "spin") {
+		this->set_wait_strategy(WAIT_SPIN);
+	}
+	else if (waitStrategy == "busy") {
+		this->set_wait_strategy(WAIT_BUSY_POLL);
+	}
+	else {
+		if (waitStrategy != "block") {
+			spdlog::error("[Threads] Invalid WAIT_STRATEGY ({}) -> block", waitStrategy);
+		}
+		this->set_wait_strategy(WAIT_BLOCK);
+	}
+	int spinUsec = reader.GetInteger("Threads", "SPIN_USEC", 50);
+	if (spinUsec < 0) spinUsec = 0;
+	this->set_spin_usec(spinUsec);
+	int busyPollUsec = reader.GetInteger("Threads", "BUSY_POLL_USEC", 50);
+	if (busyPollUsec < 0) busyPollUsec = 0;
+	this->set_busy_poll_usec(busyPollUsec);
+
+	// IO_ENGINE (epoll / uring)
+	if (reader.Get("Common", "IO_ENGINE", "epoll") == "uring") {
+		this->set_io_engine(IO_ENGINE_URING);
+	}
+	else {
+		this->set_io_engine(IO_ENGINE_EPOLL);
+	}
+
+	// LISTEN_BACKLOG
+	int backlog = reader.GetInteger("Common", "LISTEN_BACKLOG", BACKLOG);
+	if (backlog < 1) backlog = BACKLOG;
+	this->set_listen_backlog(backlog);
+
+	// DEFER_ACCEPT_SEC
+	int deferSec = reader.GetInteger("Common", "DEFER_ACCEPT_SEC", 1);
+	if (deferSec < 0) deferSec = 0;
+	this->set_defer_accept_sec(deferSec);
+
+	// IDLE_TIMEOUT_SEC
+	int idleSec = reader.GetInteger("Common", "IDLE_TIMEOUT_SEC", 60);
+	if (idleSec < 0) idleSec = 0;
+	this->set_idle_timeout_sec(idleSec);
+
+	// PING_INTERVAL_SEC (IDLE_TIMEOUT_SEC 보다 짧아야 의미가 있다)
+	int pingSec = reader.GetInteger("Common", "PING_INTERVAL_SEC", 0);
+	if (pingSec < 0 || idleSec == 0 || pingSec >= idleSec) pingSec = 0;
+	this->set_ping_interval_sec(pingSec);
+
+	// SHUTDOWN_DRAIN_SEC
+	int drainSec = reader.GetInteger("Common", "SHUTDOWN_DRAIN_SEC", 5);
+	if (drainSec < 0) drainSec = 0;
+	this->set_shutdown_drain_sec(drainSec);
+
+	// SEND_HIGH_WATER, SEND_LOW_WATER (LOW 가 HIGH 이상이면 HIGH 의 1/4)
+	int sendHigh = reader.GetInteger("Common", "SEND_HIGH_WATER", 262144);
+	int sendLow = reader.GetInteger("Common", "SEND_LOW_WATER", 65536);
+	if (sendHigh < 0) sendHigh = 0;
+	if (sendLow < 0 || sendLow >= sendHigh) sendLow = sendHigh / 4;
+	this->set_send_high_water(sendHigh);
+	this->set_send_low_water(sendLow);
+
+	// FRAME_HIGH_WATER, FRAME_LOW_WATER
+	int frameHigh = reader.GetInteger("Common", "FRAME_HIGH_WATER", 256);
+	int frameLow = reader.GetInteger("Common", "FRAME_LOW_WATER", 64);
+	if (frameHigh < 0) frameHigh = 0;
+	if (frameLow < 0 || frameLow >= frameHigh) frameLow = frameHigh / 4;
+	this->set_frame_high_water(frameHigh);
+	this->set_frame_low_water(frameLow);
+
+	// AOI_WORLD_SIZE, AOI_CELL_SIZE, AOI_VIEW_RANGE
+	int worldSize = reader.GetInteger("Common", "AOI_WORLD_SIZE", 10000);
+	int cellSize = reader.GetInteger("Common", "AOI_CELL_SIZE", 100);
+	int viewRange = reader.GetInteger("Common", "AOI_VIEW_RANGE", 1);
+	if (worldSize < 1) worldSize = 10000;
+	if (cellSize < 1 || cellSize > worldSize) cellSize = worldSize;
+	if (viewRange < 0) viewRange = 0;
+	this->set_aoi_world_size(worldSize);
+	this->set_aoi_cell_size(cellSize);
+	this->set_aoi_view_range(viewRange);
+
+	// UDP_PORT
+	int udpPort = reader.GetInteger("Common", "UDP_PORT", 0);
+	if (udpPort < 0 || udpPort > 65535) udpPort = 0;
+	this->set_udp_port(udpPort);
+
+	// READ_BUFFER_MIRROR (0 : 선형 Buffer, 1 : mirror)
+	this->set_read_buffer_mirror(reader.GetInteger("Common", "READ_BUFFER_MIRROR", 1) != 0);
+
+	// MAX_PACKET_SIZE (MAX_SOCKBUF : 큰 Packet 사용 안함, packet_len 이 unsigned short 이므로 65535 까지)
+	int maxPacketSize = reader.GetInteger("Common", "MAX_PACKET_SIZE", 65535);
+	if (maxPacketSize < MAX_SOCKBUF) maxPacketSize = MAX_SOCKBUF;
+	if (maxPacketSize > 65535) maxPacketSize = 65535;
+	this->set_max_packet_size(maxPacketSize);
+
+	// BUFFER_ARENA_MB (0 : 사용 안함), BUFFER_HUGEPAGE (0 : 일반 page, 1 : hugepage)
+	int arenaMB = reader.GetInteger("Common", "BUFFER_ARENA_MB", 0);
+	if (arenaMB < 0) arenaMB = 0;
+	this->set_buffer_arena_mb(arenaMB);
+	this->set_buffer_hugepage(reader.GetInteger("Common", "BUFFER_HUGEPAGE", 0) != 0);
+
+	// SHARED_RECV_BUFFER (0 : 세션 Buffer 로 받기, 1 : Thread 공용 Buffer 로 받기)
+	this->set_shared_recv_buffer(reader.GetInteger("Common", "SHARED_RECV_BUFFER", 0) != 0);
+
+	// HOT_RESTART_PATH
+	this->set_hot_restart_path(reader.Get("Common", "HOT_RESTART_PATH", "").c_str(), strlen(reader.Get("Common", "HOT_RESTART_PATH", "").c_str()));
+
 
 	// DB Default Setting
 	// REDIS_IP
@@ -43,3 +175,32 @@ void ConfigSetting::loadSettingData()
 
 	spdlog::info("Server Setting Load Complete..!");
 }
+
+void ConfigSetting::parse_cpu_list(const std::string & value, std::vector<int>& out)
+{
+	// 잘못된 항목은 건너뛴다.
+	out.clear();
+	std::stringstream stream(value);
+	std::string item;
+	while (std::getline(stream, item, ',')) {
+		item.erase(std::remove_if(item.begin(), item.end(), ::isspace), item.end());
+		if (item.empty()) continue;
+		int first = -1;
+		int last = -1;
+		size_t dash = item.find('-');
+		if (dash == std::string::npos) {
+			first = last = atoi(item.c_str());
+		}
+		else {
+			first = atoi(item.substr(0, dash).c_str());
+			last = atoi(item.substr(dash + 1).c_str());
+		}
+		if (first < 0 || last < first || last >= CPU_SETSIZE || (first == 0 && item[0] != '0')) {
+			spdlog::error("[Threads] Invalid CPU list item ({}) in ({})", item, value);
+			continue;
+		}
+		for (int cpu = first; cpu <= last; cpu++) {
+			out.emplace_back(cpu);
+		}
+	}
+}
@@ -4,12 +4,58 @@
 #include "../Main.h"
 #include "INIReader.h"
 
+#include <vector>
+#include <sstream>
+#include <algorithm>
+#include <sched.h>
+
+#define MAX_LOGIC_CNT 16		// Logic_API shard 최대 수
+
+// I/O 엔진
+enum IOEngineType {
+	IO_ENGINE_EPOLL,	// 기본
+	IO_ENGINE_URING		// io_uring (USE_IO_URING 빌드)
+};
+
+// Reactor, Logic_API 대기 방식 (WaitPolicy.h)
+enum WaitStrategy {
+	WAIT_BLOCK,			// 기본 : 잠든다
+	WAIT_SPIN,			// SPIN_USEC 동안 확인 후 잠든다
+	WAIT_BUSY_POLL		// 잠들지 않는다 (SO_BUSY_POLL)
+};
+
 class ConfigSetting {
 public:
 	ConfigSetting() {
 		SERVER_PORT = -1;
 		MAX_PLAYER = -1;
 		LIMIT_ERROR_CNT = -1;
+		REACTOR_CNT = 0;
+		WORKER_CNT = -1;
+		LOGIC_CNT = 1;
+		NUMA_NODE = -1;
+		WAIT_STRATEGY = WAIT_BLOCK;
+		SPIN_USEC = 0;
+		BUSY_POLL_USEC = 0;
+		IO_ENGINE = IO_ENGINE_EPOLL;
+		LISTEN_BACKLOG = -1;
+		DEFER_ACCEPT_SEC = 0;
+		IDLE_TIMEOUT_SEC = 0;
+		PING_INTERVAL_SEC = 0;
+		SHUTDOWN_DRAIN_SEC = 0;
+		SEND_HIGH_WATER = 0;
+		SEND_LOW_WATER = 0;
+		FRAME_HIGH_WATER = 0;
+		FRAME_LOW_WATER = 0;
+		AOI_WORLD_SIZE = 0;
+		AOI_CELL_SIZE = 0;
+		AOI_VIEW_RANGE = 0;
+		UDP_PORT = 0;
+		READ_BUFFER_MIRROR = false;
+		MAX_PACKET_SIZE = 0;
+		BUFFER_ARENA_MB = 0;
+		BUFFER_HUGEPAGE = false;
+		SHARED_RECV_BUFFER = false;
 		UNIQUE_NO = -1;
 		REDIS_IP = NULL;
 		REDIS_PW = NULL;
@@ -17,6 +63,7 @@ public:
 		SQL_ID = NULL;
 		SQL_PW = NULL;
 		SQL_DB = NULL;
+		HOT_RESTART_PATH = NULL;
 	}
 	void loadSettingData();
 
@@ -25,21 +72,77 @@ public:
 	const int get_server_port() { return SERVER_PORT; }
 	const int get_max_player() { return MAX_PLAYER; }
 	const int get_limit_err_cnt() { return LIMIT_ERROR_CNT; }
+	const int get_reactor_cnt() { return REACTOR_CNT; }
+	const int get_worker_cnt() { return WORKER_CNT; }
+	const int get_logic_cnt() { return LOGIC_CNT; }
+	const int get_numa_node() { return NUMA_NODE; }
+	const std::vector<int>& get_thread_cpu(const THREAD_ROLE role) { return THREAD_CPU[role]; }
+	const WaitStrategy get_wait_strategy() { return WAIT_STRATEGY; }
+	const int get_spin_usec() { return SPIN_USEC; }
+	const int get_busy_poll_usec() { return BUSY_POLL_USEC; }
+	const IOEngineType get_io_engine() { return IO_ENGINE; }
+	const int get_listen_backlog() { return LISTEN_BACKLOG; }
+	const int get_defer_accept_sec() { return DEFER_ACCEPT_SEC; }
+	const int get_idle_timeout_sec() { return IDLE_TIMEOUT_SEC; }
+	const int get_ping_interval_sec() { return PING_INTERVAL_SEC; }
+	const int get_shutdown_drain_sec() { return SHUTDOWN_DRAIN_SEC; }
+	const int get_send_high_water() { return SEND_HIGH_WATER; }
+	const int get_send_low_water() { return SEND_LOW_WATER; }
+	const int get_frame_high_water() { return FRAME_HIGH_WATER; }
+	const int get_frame_low_water() { return FRAME_LOW_WATER; }
+	const int get_aoi_world_size() { return AOI_WORLD_SIZE; }
+	const int get_aoi_cell_size() { return AOI_CELL_SIZE; }
+	const int get_aoi_view_range() { return AOI_VIEW_RANGE; }
+	const int get_udp_port() { return UDP_PORT; }
+	const bool get_read_buffer_mirror() { return READ_BUFFER_MIRROR; }
+	const int get_max_packet_size() { return MAX_PACKET_SIZE; }
+	const int get_buffer_arena_mb() { return BUFFER_ARENA_MB; }
+	const bool get_buffer_hugepage() { return BUFFER_HUGEPAGE; }
+	const bool get_shared_recv_buffer() { return SHARED_RECV_BUFFER; }
 	const char* get_redis_ip() { return REDIS_IP; }
 	const char* get_redis_pw() { return REDIS_PW; }
 	const char* get_sql_host() { return SQL_HOST; }
 	const char* get_sql_id() { return SQL_ID; }
 	const char* get_sql_pw() { return SQL_PW; }
 	const char* get_sql_db() { return SQL_DB; }
+	const char* get_hot_restart_path() { return HOT_RESTART_PATH; }
 
 	// public set
 	void set_unique_no(const unsigned_int64 value) { UNIQUE_NO = value; }
 	void incr_unique_no() { UNIQUE_NO++; }
+	static void parse_cpu_list(const std::string& value, std::vector<int>& out);	// "0-3,8" -> 0, 1, 2, 3, 8
 
 private:
 	int SERVER_PORT;				// 서버 포트
 	int MAX_PLAYER;					// 최대 플레이어
 	int LIMIT_ERROR_CNT;			// 최대 제한 cnt
+	int REACTOR_CNT;				// Reactor 수 (0 : 단일 EventThread 모드)
+	int WORKER_CNT;					// WorkerThread 수 (1 ~ MAX_WORKERTHREAD)
+	int LOGIC_CNT;					// Logic_API shard 수 (1 ~ MAX_LOGIC_CNT, 세션 slot 으로 나눈다)
+	int NUMA_NODE;					// Thread 를 묶을 NUMA node (-1 : 사용 안함)
+	std::vector<int> THREAD_CPU[MAX_THREAD_ROLE];	// 역할 별 CPU 목록 (비어 있으면 고정 안함)
+	WaitStrategy WAIT_STRATEGY;		// Reactor, Logic_API 대기 방식 (block / spin / busy)
+	int SPIN_USEC;					// spin : 잠들기 전 확인 시간
+	int BUSY_POLL_USEC;				// busy : 소켓 SO_BUSY_POLL 값
+	IOEngineType IO_ENGINE;			// I/O 엔진 (epoll / uring)
+	int LISTEN_BACKLOG;				// 접속 대기 큐 (somaxconn 까지)
+	int DEFER_ACCEPT_SEC;			// TCP_DEFER_ACCEPT 대기 시간 (0 : 사용 안함)
+	int IDLE_TIMEOUT_SEC;			// 수신이 없는 세션 종료 시간 (0 : 사용 안함)
+	int PING_INTERVAL_SEC;			// 유휴 세션 ping 간격 (0 : 사용 안함)
+	int SHUTDOWN_DRAIN_SEC;			// 종료시 남은 Packet 처리, 전송 최대 대기 시간
+	int SEND_HIGH_WATER;			// 전송 대기 byte 가 넘으면 수신 중단 (0 : 사용 안함)
+	int SEND_LOW_WATER;				// 전송 대기 byte 가 이하로 내려가면 수신 재개
+	int FRAME_HIGH_WATER;			// 처리 대기 Packet 수가 넘으면 수신 중단 (0 : 사용 안함)
+	int FRAME_LOW_WATER;			// 처리 대기 Packet 수가 이하로 내려가면 수신 재개
+	int AOI_WORLD_SIZE;				// 월드 한 변 크기
+	int AOI_CELL_SIZE;				// AOI 격자 한 칸 크기
+	int AOI_VIEW_RANGE;				// 이동을 받는 주변 칸 수 (1 : 3x3)
+	int UDP_PORT;					// 이동 Packet UDP 포트 (0 : 사용 안함)
+	bool READ_BUFFER_MIRROR;		// 수신 Buffer 를 memfd 두번 map 으로 (세션 당 map 2개, vm.max_map_count 확인)
+	int MAX_PACKET_SIZE;			// 받을 수 있는 최대 Packet (MAX_SOCKBUF ~ 65535, 넘으면 Chain_Buffer)
+	int BUFFER_ARENA_MB;			// Buffer_Pool linear block 을 미리 잡아두는 크기 (0 : 사용 안함, 필요할 때 new)
+	bool BUFFER_HUGEPAGE;			// arena 를 hugepage 로 (MAP_HUGETLB, 실패하면 THP madvise)
+	bool SHARED_RECV_BUFFER;		// I/O Thread 공용 Buffer 로 받고, 완성되지 않은 조각만 세션 Buffer 로 옮긴다.
 	unsigned_int64 UNIQUE_NO;	// 고유 아이디 시작 번호
 	char* REDIS_IP;					// 레디스 접속 아이피
 	char* REDIS_PW;					// 레디스 접속 비밀번호
@@ -47,11 +150,39 @@ private:
 	char* SQL_ID;					// SQL 접속 아이디
 	char* SQL_PW;					// SQL 접속 비밀번호
 	char* SQL_DB;					// SQL 접속 DB
+	char* HOT_RESTART_PATH;			// Hot Restart Unix 소켓 경로 (빈 값 : 사용 안함, 실행 사용자 전용 디렉터리 예 : /run/user/<uid>)
 
 	// private set
 	void set_server_port(const int value) { SERVER_PORT = value; }
 	void set_max_player(const int value) { MAX_PLAYER = value; }
 	void set_limit_err_cnt(const int value) { LIMIT_ERROR_CNT = value; }
+	void set_reactor_cnt(const int value) { REACTOR_CNT = value; }
+	void set_worker_cnt(const int value) { WORKER_CNT = value; }
+	void set_logic_cnt(const int value) { LOGIC_CNT = value; }
+	void set_numa_node(const int value) { NUMA_NODE = value; }
+	void set_thread_cpu(const THREAD_ROLE role, const std::string& value) { parse_cpu_list(value, THREAD_CPU[role]); }
+	void set_wait_strategy(const WaitStrategy value) { WAIT_STRATEGY = value; }
+	void set_spin_usec(const int value) { SPIN_USEC = value; }
+	void set_busy_poll_usec(const int value) { BUSY_POLL_USEC = value; }
+	void set_io_engine(const IOEngineType value) { IO_ENGINE = value; }
+	void set_listen_backlog(const int value) { LISTEN_BACKLOG = value; }
+	void set_defer_accept_sec(const int value) { DEFER_ACCEPT_SEC = value; }
+	void set_idle_timeout_sec(const int value) { IDLE_TIMEOUT_SEC = value; }
+	void set_ping_interval_sec(const int value) { PING_INTERVAL_SEC = value; }
+	void set_shutdown_drain_sec(const int value) { SHUTDOWN_DRAIN_SEC = value; }
+	void set_send_high_water(const int value) { SEND_HIGH_WATER = value; }
+	void set_send_low_water(const int value) { SEND_LOW_WATER = value; }
+	void set_frame_high_water(const int value) { FRAME_HIGH_WATER = value; }
+	void set_frame_low_water(const int value) { FRAME_LOW_WATER = value; }
+	void set_aoi_world_size(const int value) { AOI_WORLD_SIZE = value; }
+	void set_aoi_cell_size(const int value) { AOI_CELL_SIZE = value; }
+	void set_aoi_view_range(const int value) { AOI_VIEW_RANGE = value; }
+	void set_udp_port(const int value) { UDP_PORT = value; }
+	void set_read_buffer_mirror(const bool value) { READ_BUFFER_MIRROR = value; }
+	void set_max_packet_size(const int value) { MAX_PACKET_SIZE = value; }
+	void set_buffer_arena_mb(const int value) { BUFFER_ARENA_MB = value; }
+	void set_buffer_hugepage(const bool value) { BUFFER_HUGEPAGE = value; }
+	void set_shared_recv_buffer(const bool value) { SHARED_RECV_BUFFER = value; }
 	void set_redis_ip(const char* value, const unsigned_int64 size) {
 		REDIS_IP = new char[size];
 		memset(REDIS_IP, 0, size);
@@ -112,5 +243,14 @@ private:
 #endif
 		SQL_DB[size] = '\0';
 	}
+	void set_hot_restart_path(const char* value, const unsigned_int64 size) {
+		HOT_RESTART_PATH = new char[size + 1];
+		memset(HOT_RESTART_PATH, 0, size + 1);
+#ifdef _MSC_VER
+		memcpy_s(HOT_RESTART_PATH, size, value, size);
+#else
+		memcpy(HOT_RESTART_PATH, value, size);
+#endif
+	}
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,395 @@
+﻿#include "HotRestart.h"
+
+Hot_Restart::Hot_Restart()
+{
+	listenFd = -1;
+	listenPos = 0;
+}
+
+Hot_Restart::~Hot_Restart()
+{
+	if (listenFd >= 0) {
+		close(listenFd);
+	}
+}
+
+bool Hot_Restart::takeover(const char* path)
+{
+	if (path == nullptr || path[0] == '\0') {
+		return false;
+	}
+
+	int conn = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+	if (conn < 0) {
+		spdlog::error("[HotRestart] socket() Function failure : {}", strerror(errno));
+		return false;
+	}
+	struct sockaddr_un addr;
+	memset(&addr, 0, sizeof addr);
+	addr.sun_family = AF_UNIX;
+	strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+	if (connect(conn, (struct sockaddr *) &addr, sizeof addr) < 0) {
+		// 실행중인 서버가 없다. (일반 시작)
+		close(conn);
+		return false;
+	}
+	// 공유 디렉터리의 경로를 다른 사용자가 먼저 만들었을 수 있다.
+	if (!check_peer(conn)) {
+		close(conn);
+		return false;
+	}
+	spdlog::info("[HotRestart] Connect ({}) -> takeover", path);
+	set_timeout(conn);
+
+	// 이전 프로세스는 READY 를 받은 뒤에 I/O 를 멈춘다.
+	HOT_Msg msg;
+	init_msg(msg, HOT_MSG_READY);
+	if (!sendMsg(conn, msg, nullptr, 0)) {
+		close(conn);
+		return false;
+	}
+
+	// Listen 소켓
+	int fds[HOT_RESTART_MAX_LISTEN];
+	int fdCnt = 0;
+	if (!recvMsg(conn, msg, fds, HOT_RESTART_MAX_LISTEN, fdCnt) || msg.type != HOT_MSG_HELLO) {
+		spdlog::error("[HotRestart] HELLO recv failure");
+		close(conn);
+		return false;
+	}
+	listenSocks.assign(fds, fds + fdCnt);
+	sessions.reserve(msg.sessionCnt);
+
+	// 세션 소켓, 상태
+	while (true) {
+		fdCnt = 0;
+		if (!recvMsg(conn, msg, fds, 1, fdCnt)) {
+			break;
+		}
+		if (msg.type == HOT_MSG_END) {
+			// 모두 받았다 -> 이전 프로세스는 종료 한다.
+			init_msg(msg, HOT_MSG_ACK);
+			bool acked = sendMsg(conn, msg, nullptr, 0);
+			close(conn);
+			if (!acked) {
+				break;
+			}
+			spdlog::info("[HotRestart] takeover Complete..! (listen : {}, sessions : {})", listenSocks.size(), sessions.size());
+			return true;
+		}
+		if (msg.type != HOT_MSG_SESSION || fdCnt != 1) {
+			spdlog::error("[HotRestart] Unknown message type({}) fdCnt({})", msg.type, fdCnt);
+			if (fdCnt > 0) close(fds[0]);
+			break;
+		}
+		HOT_Session session;
+		session.sock = fds[0];
+		session.unique_no = msg.unique_no;
+		if (!recvData(conn, session.readData, msg.readSize) || !recvData(conn, session.sendData, msg.sendSize)) {
+			close(session.sock);
+			break;
+		}
+		sessions.emplace_back(std::move(session));
+	}
+
+	// 이전 프로세스는 ACK 를 받지 못하여 정상 종료 한다.
+	spdlog::error("[HotRestart] takeover failure -> normal start");
+	close(conn);
+	close_received();
+	return false;
+}
+
+void Hot_Restart::restore()
+{
+	int restoreCnt = 0;
+	for (auto& session : sessions) {
+		if (epoll_server.RestoreSession(session.sock, session.unique_no, session.readData, session.sendData)) {
+			restoreCnt++;
+		}
+	}
+	if (!sessions.empty()) {
+		spdlog::info("[HotRestart] Restore sessions : {} / {}", restoreCnt, sessions.size());
+	}
+	sessions.clear();
+
+	// 모드가 바뀌어 남은 Listen 소켓 (대기중인 연결은 reset 된다)
+	for (; listenPos < listenSocks.size(); listenPos++) {
+		spdlog::error("[HotRestart] Unused listen socket close : {}", listenSocks[listenPos]);
+		close(listenSocks[listenPos]);
+	}
+	listenSocks.clear();
+	listenPos = 0;
+}
+
+bool Hot_Restart::listen_handoff(const char* path)
+{
+	if (path == nullptr || path[0] == '\0') {
+		return false;
+	}
+
+	// 이전 프로세스의 경로는 지우고 새로 만든다.
+	unlink(path);
+	if ((listenFd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)) < 0) {
+		spdlog::error("[HotRestart] socket() Function failure : {}", strerror(errno));
+		return false;
+	}
+	struct sockaddr_un addr;
+	memset(&addr, 0, sizeof addr);
+	addr.sun_family = AF_UNIX;
+	strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+	// 실행 사용자만 연결 할 수 있다. (다른 사용자는 handoff 의 SO_PEERCRED 에서도 거절 된다)
+	if (bind(listenFd, (struct sockaddr *) &addr, sizeof addr) < 0 || chmod(path, S_IRUSR | S_IWUSR) < 0 || listen(listenFd, 1) < 0) {
+		spdlog::error("[HotRestart] bind({}) Function failure : {}", path, strerror(errno));
+		close(listenFd);
+		listenFd = -1;
+		return false;
+	}
+	spdlog::info("[HotRestart] Wait next process ({})", path);
+	return true;
+}
+
+HOT_RESULT Hot_Restart::handoff()
+{
+	int conn = accept4(listenFd, NULL, NULL, SOCK_CLOEXEC);
+	if (conn < 0) {
+		return HOT_SKIP;
+	}
+	set_timeout(conn);
+
+	// 0. I/O 를 멈추기 전에 확인 한다. (실패하면 연결만 닫고 계속 서비스)
+	HOT_Msg msg;
+	int fdCnt = 0;
+	std::vector<int> socks = epoll_server.get_listen_socks();
+	if (!check_peer(conn) || !recvMsg(conn, msg, nullptr, 0, fdCnt) || msg.type != HOT_MSG_READY
+		|| socks.empty() || socks.size() > HOT_RESTART_MAX_LISTEN) {
+		spdlog::error("[HotRestart] Next process check failure -> continue service");
+		close(conn);
+		return HOT_SKIP;
+	}
+	spdlog::info("[HotRestart] Next process connected -> handoff");
+
+	// 1. accept, 수신 중단 (Listen 소켓은 넘겨야 하므로 닫지 않는다, 그 동안의 연결은 backlog 에 쌓인다)
+	epoll_server.StopIoThreads();
+
+	// 2. 처리중인 Packet 완료 (Redis 기록 포함)
+	api.stop(std::chrono::steady_clock::now() + std::chrono::seconds(CS.get_shutdown_drain_sec()));
+
+	// 3. Listen 소켓
+	init_msg(msg, HOT_MSG_HELLO);
+	msg.listenCnt = (int)socks.size();
+	if (!sendMsg(conn, msg, socks.data(), (int)socks.size())) {
+		return fail_handoff(conn);
+	}
+
+	// 4. 세션 소켓, 읽지 않은 데이터, 보내지 못한 데이터
+	int sessionCnt = 0;
+	std::string sendQueueData;
+	for (int slot = 0; slot < epoll_server.get_max_session(); slot++) {
+		auto pPlayerSession = epoll_server.getSessionBySlot(slot);
+		if (pPlayerSession == nullptr) continue;
+		{
+			std::lock_guard<std::mutex> sendGuard(pPlayerSession->send_mutex());
+			pPlayerSession->copy_sendQueue(sendQueueData);
+		}
+		auto& readBuffer = pPlayerSession->read_buffer();
+		int sock = pPlayerSession->get_sock();
+		init_msg(msg, HOT_MSG_SESSION);
+		msg.unique_no = pPlayerSession->get_unique_no();
+		msg.readSize = readBuffer.getReadAbleSize();
+		msg.sendSize = (int)sendQueueData.size();
+		const char* pReadData = readBuffer.getReadBuffer();
+		std::string chainData;
+		if (pPlayerSession->get_chain() != nullptr) {
+			// 받는 중인 큰 Packet (ReadBuffer 는 비어 있다)
+			chainData.resize(pPlayerSession->get_chain()->get_filled());
+			pPlayerSession->get_chain()->copy_to(&chainData[0]);
+			pReadData = chainData.data();
+			msg.readSize = (int)chainData.size();
+		}
+		if (!sendMsg(conn, msg, &sock, 1) || !sendData(conn, pReadData, msg.readSize)
+			|| !sendData(conn, sendQueueData.data(), msg.sendSize)) {
+			return fail_handoff(conn);
+		}
+		sessionCnt++;
+	}
+
+	// 5. 새 프로세스가 모두 받으면 종료 한다.
+	init_msg(msg, HOT_MSG_END);
+	msg.sessionCnt = sessionCnt;
+	if (!sendMsg(conn, msg, nullptr, 0) || !recvMsg(conn, msg, nullptr, 0, fdCnt) || msg.type != HOT_MSG_ACK) {
+		spdlog::error("[HotRestart] ACK recv failure");
+		return fail_handoff(conn);
+	}
+	close(conn);
+	spdlog::info("[HotRestart] handoff Complete..! (listen : {}, sessions : {})", socks.size(), sessionCnt);
+	return HOT_DONE;
+}
+
+int Hot_Restart::take_listen_sock()
+{
+	if (listenPos >= listenSocks.size()) {
+		return -1;
+	}
+	return listenSocks[listenPos++];
+}
+
+void Hot_Restart::init_msg(HOT_Msg& msg, const HOT_MSG_TYPE type)
+{
+	memset(&msg, 0, sizeof msg);
+	msg.magic = HOT_RESTART_MAGIC;
+	msg.version = HOT_RESTART_VERSION;
+	msg.type = type;
+}
+
+bool Hot_Restart::sendMsg(const int conn, HOT_Msg& msg, const int* fds, const int fdCnt)
+{
+	struct iovec iov;
+	iov.iov_base = &msg;
+	iov.iov_len = sizeof msg;
+	struct msghdr hdr;
+	memset(&hdr, 0, sizeof hdr);
+	hdr.msg_iov = &iov;
+	hdr.msg_iovlen = 1;
+
+	// fd 는 SCM_RIGHTS 로 같이 보낸다. (받는 쪽에 새 fd 로 복제 된다)
+	char control[CMSG_SPACE(sizeof(int) * HOT_RESTART_MAX_LISTEN)];
+	if (fdCnt > 0) {
+		memset(control, 0, sizeof control);
+		hdr.msg_control = control;
+		hdr.msg_controllen = CMSG_SPACE(sizeof(int) * fdCnt);
+		struct cmsghdr *cmsg = CMSG_FIRSTHDR(&hdr);
+		cmsg->cmsg_level = SOL_SOCKET;
+		cmsg->cmsg_type = SCM_RIGHTS;
+		cmsg->cmsg_len = CMSG_LEN(sizeof(int) * fdCnt);
+		memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * fdCnt);
+	}
+	while (sendmsg(conn, &hdr, MSG_NOSIGNAL) < 0) {
+		if (errno == EINTR) continue;
+		spdlog::error("[HotRestart] sendmsg() Function failure : {}", strerror(errno));
+		return false;
+	}
+	return true;
+}
+
+bool Hot_Restart::recvMsg(const int conn, HOT_Msg& msg, int* fds, const int maxFd, int& fdCnt)
+{
+	struct iovec iov;
+	iov.iov_base = &msg;
+	iov.iov_len = sizeof msg;
+	struct msghdr hdr;
+	memset(&hdr, 0, sizeof hdr);
+	hdr.msg_iov = &iov;
+	hdr.msg_iovlen = 1;
+	char control[CMSG_SPACE(sizeof(int) * HOT_RESTART_MAX_LISTEN)];
+	hdr.msg_control = control;
+	hdr.msg_controllen = sizeof control;
+
+	int ioSize;
+	while ((ioSize = recvmsg(conn, &hdr, MSG_CMSG_CLOEXEC)) < 0 && errno == EINTR);
+	if (ioSize != sizeof msg || msg.magic != HOT_RESTART_MAGIC || msg.version != HOT_RESTART_VERSION) {
+		spdlog::error("[HotRestart] recvmsg() failure : size({}) errno({})", ioSize, errno);
+		return false;
+	}
+
+	fdCnt = 0;
+	for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&hdr); cmsg != NULL; cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
+		if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) continue;
+		int cnt = (int)((cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int));
+		int *pFd = (int *)CMSG_DATA(cmsg);
+		for (int i = 0; i < cnt; i++) {
+			// 예상보다 많이 온 fd 는 닫는다.
+			if (fdCnt < maxFd) {
+				fds[fdCnt++] = pFd[i];
+			}
+			else {
+				close(pFd[i]);
+			}
+		}
+	}
+	if (hdr.msg_flags & MSG_CTRUNC) {
+		spdlog::error("[HotRestart] recvmsg() control truncated");
+		return false;
+	}
+	return true;
+}
+
+bool Hot_Restart::sendData(const int conn, const char* pData, const int size)
+{
+	// SOCK_SEQPACKET 이므로 CHUNK 단위 메시지로 나눠 보낸다.
+	int offset = 0;
+	while (offset < size) {
+		int chunk = std::min(size - offset, HOT_RESTART_CHUNK);
+		int ioSize = send(conn, pData + offset, chunk, MSG_NOSIGNAL);
+		if (ioSize < 0) {
+			if (errno == EINTR) continue;
+			spdlog::error("[HotRestart] send() Function failure : {}", strerror(errno));
+			return false;
+		}
+		offset += ioSize;
+	}
+	return true;
+}
+
+bool Hot_Restart::recvData(const int conn, std::string& out, const int size)
+{
+	out.resize(size);
+	int offset = 0;
+	while (offset < size) {
+		int ioSize = recv(conn, &out[offset], std::min(size - offset, HOT_RESTART_CHUNK), 0);
+		if (ioSize <= 0) {
+			if (ioSize < 0 && errno == EINTR) continue;
+			spdlog::error("[HotRestart] recv() failure : size({}) errno({})", ioSize, errno);
+			return false;
+		}
+		offset += ioSize;
+	}
+	return true;
+}
+
+void Hot_Restart::set_timeout(const int conn)
+{
+	// 상대 프로세스가 멈춘 경우 무한 대기 하지 않는다.
+	struct timeval tv;
+	tv.tv_sec = HOT_RESTART_TIMEOUT_SEC;
+	tv.tv_usec = 0;
+	setsockopt(conn, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof tv);
+	setsockopt(conn, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof tv);
+}
+
+bool Hot_Restart::check_peer(const int conn)
+{
+	struct ucred cred;
+	socklen_t len = sizeof cred;
+	if (getsockopt(conn, SOL_SOCKET, SO_PEERCRED, &cred, &len) < 0) {
+		spdlog::error("[HotRestart] getsockopt(SO_PEERCRED) Function failure : {}", strerror(errno));
+		return false;
+	}
+	if (cred.uid != getuid()) {
+		spdlog::error("[HotRestart] Peer uid({}) pid({}) is not server uid({}) -> reject", cred.uid, cred.pid, getuid());
+		return false;
+	}
+	return true;
+}
+
+HOT_RESULT Hot_Restart::fail_handoff(const int conn)
+{
+	// 새 프로세스는 ACK 를 보내지 못했으므로 받은 소켓을 닫고 종료 한다. (세션은 이 프로세스에 그대로 있다)
+	close(conn);
+	api.start();
+	epoll_server.ResumeIoThreads();
+	spdlog::error("[HotRestart] handoff failure -> continue service");
+	return HOT_FAIL;
+}
+
+void Hot_Restart::close_received()
+{
+	for (auto sock : listenSocks) {
+		close(sock);
+	}
+	listenSocks.clear();
+	listenPos = 0;
+	for (auto& session : sessions) {
+		close(session.sock);
+	}
+	sessions.clear();
+}
@@ -0,0 +1,88 @@
+﻿#ifndef __HOT_RESTART_H__
+#define __HOT_RESTART_H__
+
+#include "Main.h"
+
+#include <string>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#define HOT_RESTART_MAGIC 0x48525354		// 'HRST'
+#define HOT_RESTART_VERSION 2
+#define HOT_RESTART_CHUNK 65536				// 세션 데이터 전송 단위 (SOCK_SEQPACKET 메시지 1개)
+#define HOT_RESTART_MAX_LISTEN 64			// 넘겨 받는 Listen 소켓 최대 수
+#define HOT_RESTART_TIMEOUT_SEC 10			// 메시지 송수신 대기 시간
+
+// 프로세스 사이 메시지 종류
+enum HOT_MSG_TYPE {
+	HOT_MSG_HELLO = 1,						// Listen 소켓 (SCM_RIGHTS), 세션 수
+	HOT_MSG_SESSION,						// 세션 소켓 1개 (SCM_RIGHTS) + 상태, 뒤에 데이터 메시지가 이어진다.
+	HOT_MSG_END,							// 전송 완료
+	HOT_MSG_ACK,							// 새 프로세스가 모두 받았다.
+	HOT_MSG_READY							// 새 프로세스가 연결 직후 보낸다. (I/O 중단 전 확인)
+};
+
+// handoff 결과
+enum HOT_RESULT {
+	HOT_SKIP,								// 연결 없음, 확인 실패 (계속 서비스)
+	HOT_FAIL,								// 넘기는 중 실패 (I/O 를 다시 시작하여 계속 서비스)
+	HOT_DONE								// 넘기기 완료 (이 프로세스는 종료 한다)
+};
+
+#pragma pack(push, 1)
+struct HOT_Msg {
+	unsigned int magic;
+	unsigned short version;
+	unsigned short type;
+	int listenCnt;							// HELLO
+	int sessionCnt;							// HELLO, END
+	unsigned_int64 unique_no;				// SESSION
+	int readSize;							// SESSION : 읽지 않은 ReadBuffer 크기
+	int sendSize;							// SESSION : 보내지 못한 sendQueue 크기
+};
+#pragma pack(pop)
+
+// 넘겨 받은 세션
+struct HOT_Session {
+	int sock;
+	unsigned_int64 unique_no;
+	std::string readData;					// 완성되지 않은 Packet 조각
+	std::string sendData;					// 보내지 못한 데이터
+};
+
+// 실행중인 서버의 Listen / 세션 소켓을 Unix 소켓 (SCM_RIGHTS) 으로 새 프로세스에 넘긴다.
+// 1. 새 프로세스 시작 -> takeover() 가 HOT_RESTART_PATH 에 연결
+//    (같은 사용자 프로세스만 허용 : SO_PEERCRED, READY 메시지 확인 후 I/O 를 멈춘다)
+// 2. 이전 프로세스 handoff() : I/O 중단, Logic_API 처리 완료, 소켓 / 세션 상태 전송 후 종료
+// 3. 새 프로세스 : 넘겨 받은 Listen 소켓으로 시작, restore() 로 세션 등록 (클라이언트 재접속 없음)
+class Hot_Restart {
+public:
+	Hot_Restart();
+	~Hot_Restart();
+	bool takeover(const char* path);									// 실행중인 서버가 있으면 소켓을 넘겨 받는다.
+	void restore();														// 넘겨 받은 세션 등록, 사용하지 않은 Listen 소켓 닫기
+	bool listen_handoff(const char* path);								// 다음 프로세스 연결 대기 소켓
+	HOT_RESULT handoff();												// 다음 프로세스에 모든 소켓을 넘긴다.
+	int take_listen_sock();												// 넘겨 받은 Listen 소켓 (순서대로, 없으면 -1)
+
+	// get
+	int get_fd() { return listenFd; }
+
+private:
+	int listenFd;
+	std::vector<int> listenSocks;										// 넘겨 받은 Listen 소켓
+	size_t listenPos;													// take_listen_sock 위치
+	std::vector<HOT_Session> sessions;									// 넘겨 받은 세션
+	void init_msg(HOT_Msg& msg, const HOT_MSG_TYPE type);
+	bool sendMsg(const int conn, HOT_Msg& msg, const int* fds, const int fdCnt);
+	bool recvMsg(const int conn, HOT_Msg& msg, int* fds, const int maxFd, int& fdCnt);
+	bool sendData(const int conn, const char* pData, const int size);
+	bool recvData(const int conn, std::string& out, const int size);
+	void set_timeout(const int conn);
+	bool check_peer(const int conn);									// 상대 프로세스가 같은 사용자 인지 (SO_PEERCRED)
+	HOT_RESULT fail_handoff(const int conn);							// I/O, Logic_API 다시 시작 (계속 서비스)
+	void close_received();												// 실패시 넘겨 받은 소켓 정리
+};
+
+#endif
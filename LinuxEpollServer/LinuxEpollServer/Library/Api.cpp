@@ -2,22 +2,48 @@
 
 bool Logic_API::start()
 {
+	// I/O Thread 가 Packet 을 넣기 전에 (init_server 전) 호출 한다.
+	// Hot Restart 실패로 다시 시작하면 기존 Shard (Queue 에 남은 Packet) 를 그대로 사용한다.
 	threadRun = true;
-	api_thread = std::thread([this]() { API_Thread(); });
+	if (mShards.empty()) {
+		mShards.reserve(CS.get_logic_cnt());
+		for (int i = 0; i < CS.get_logic_cnt(); i++) {
+			LogicShard *pShard = new LogicShard;
+			pShard->shardNo = i;
+			mShards.emplace_back(pShard);
+		}
+	}
+	for (auto pShard : mShards) {
+		pShard->api_thread = std::thread([this, pShard]() { API_Thread(pShard); });
+	}
+	spdlog::info("Logic API Thread Start..! (LOGIC_CNT : {})", mShards.size());
 	return true;
 }
 
 bool Logic_API::stop()
 {
+	// deadline 을 주지 않으면 바로 종료하지 않고 설정된 drain 시간 만큼 기다린다.
+	return stop(std::chrono::steady_clock::now() + std::chrono::seconds(CS.get_shutdown_drain_sec()));
+}
+
+bool Logic_API::stop(const std::chrono::steady_clock::time_point deadline)
+{
+	drainDeadline = deadline;
 	threadRun = false;
-	if (api_thread.joinable())
-	{
-		api_thread.join();
+	// eventfd 에서 대기중인 API_Thread를 깨운다.
+	for (auto pShard : mShards) {
+		pShard->recvPacketQueue.notify();
+	}
+	for (auto pShard : mShards) {
+		if (pShard->api_thread.joinable())
+		{
+			pShard->api_thread.join();
+		}
 	}
 	return true;
 }
 
-void Logic_API::packet_Add(int sock, unsigned_int64 unique_no, char * pMsg, unsigned short packetLen)
+void Logic_API::packet_Add(session_handle handle, int sock, unsigned_int64 unique_no, char * pMsg, unsigned short packetLen)
 {
 	// Packet Header Read
 	char *packetHeader = new char[packetLen];
@@ -32,10 +58,45 @@ void Logic_API::packet_Add(int sock, unsigned_int64 unique_no, char * pMsg, unsi
 	packet_frame.packet_type = packet_header.packet_type;
 	packet_frame.size = packet_header.packet_len;
 	packet_frame.pMsg = packetHeader;
+	packet_frame.handle = handle;
 	packet_frame.sock = sock;
 	packet_frame.unique_no = unique_no;
-	std::lock_guard<std::mutex> guard(mLock);
-	api.get_PacketFrame().push(packet_frame);
+	get_shard(handle)->recvPacketQueue.push(packet_frame);
+}
+
+void Logic_API::packet_AddBatch(session_handle handle, int sock, unsigned_int64 unique_no, FRAME_View * frames, int frameCnt)
+{
+	// Header 는 OnRecv 에서 이미 검사 하였다.
+	Packet_Frame packetBatch[MAX_FRAME_BATCH];
+	for (int i = 0; i < frameCnt; i++) {
+		char *pMsg = new char[frames[i].size];
+		memcpy(pMsg, frames[i].pMsg, frames[i].size);
+		packetBatch[i].packet_type = frames[i].type;
+		packetBatch[i].size = frames[i].size;
+		packetBatch[i].pMsg = pMsg;
+		packetBatch[i].handle = handle;
+		packetBatch[i].sock = sock;
+		packetBatch[i].unique_no = unique_no;
+	}
+	// 대기중인 API_Thread 는 한번만 깨운다.
+	get_shard(handle)->recvPacketQueue.pushBatch(packetBatch, frameCnt);
+}
+
+void Logic_API::packet_AddChain(session_handle handle, int sock, unsigned_int64 unique_no, Chain_Buffer & chain)
+{
+	// block 에서 Logic_API 가 가질 Buffer 로 한번만 복사한다. (작은 Packet 의 ReadBuffer -> pMsg 복사와 같은 횟수)
+	char *pMsg = new char[chain.get_frame_size()];
+	chain.copy_to(pMsg);
+	auto pHeader = (PACKET_HEADER*)pMsg;
+
+	Packet_Frame packet_frame;
+	packet_frame.packet_type = pHeader->packet_type;
+	packet_frame.size = pHeader->packet_len;
+	packet_frame.pMsg = pMsg;
+	packet_frame.handle = handle;
+	packet_frame.sock = sock;
+	packet_frame.unique_no = unique_no;
+	get_shard(handle)->recvPacketQueue.push(packet_frame);
 }
 
 Logic_API::Logic_API()
@@ -46,76 +107,119 @@ Logic_API::Logic_API()
 Logic_API::~Logic_API()
 {
 	stop();
+	for (auto pShard : mShards) {
+		delete pShard;
+	}
 }
 
-void Logic_API::API_Thread()
+void Logic_API::API_Thread(LogicShard *pShard)
 {
-	while (threadRun) {
-		if (!recvPacketQueue.empty()) {
-			// 로직 처리를 진행
-			std::lock_guard<std::mutex> guard(mLock);
-			sc_packet_result result;
-			auto packet = recvPacketQueue.front();
-			result.packet_no = packet.packet_type;
+	topology.bind_thread(THREAD_LOGIC, pShard->shardNo);
+	switch (CS.get_wait_strategy()) {
+	case WAIT_SPIN:
+		API_Loop<Spin_Wait>(pShard);
+		break;
+	case WAIT_BUSY_POLL:
+		API_Loop<Busy_Poll>(pShard);
+		break;
+	default:
+		API_Loop<Block_Wait>(pShard);
+		break;
+	}
+}
 
-			// Protocol Base값 을 가져온다.
-			ProtocolType protocolBase = (ProtocolType)((int)packet.packet_type / (int)PACKET_RANG_SIZE * (int)PACKET_RANG_SIZE);
+template <typename WaitPolicy>
+void Logic_API::API_Loop(LogicShard *pShard)
+{
+	WaitPolicy wait(CS.get_spin_usec());
+	auto& recvPacketQueue = pShard->recvPacketQueue;
+	Packet_Frame packetBatch[MAX_API_BATCH];
+	while (true) {
+		// 종료 요청 후에는 Queue 가 빌 때 까지 (drainDeadline 까지) 처리한다.
+		if (!threadRun && (recvPacketQueue.empty() || std::chrono::steady_clock::now() >= drainDeadline)) {
+			break;
+		}
+		// Queue가 비어 있으면 WaitPolicy 에 따라 잠든다. (Block_Wait : eventfd)
+		int packetCnt = wait.pop(recvPacketQueue, packetBatch, MAX_API_BATCH);
+		for (int i = 0; i < packetCnt; i++) {
+			ProcessPacket(packetBatch[i]);
+			// 처리 대기 수를 줄이고 멈춘 수신을 다시 시작할 수 있는지 본다.
+			epoll_server.OnPacketDone(packetBatch[i].handle);
+		}
+		// 이번 묶음에서 쌓인 응답을 세션 별로 한번에 보낸다.
+		epoll_server.FlushSendAll();
+	}
 
-			// 각각의 Library로 처리를 보낸다.
-			switch (protocolBase) {
+	// 시한 안에 처리하지 못한 Packet 은 버린다.
+	int dropCnt = 0;
+	Packet_Frame packet;
+	while (recvPacketQueue.tryPop(packet)) {
+		delete[] packet.pMsg;
+		dropCnt++;
+	}
+	if (dropCnt > 0) {
+		spdlog::error("[Shutdown] Logic_API shard {} drop packets : {}", pShard->shardNo, dropCnt);
+	}
+}
 
-			case CLIENT_BASE:
-			{
+void Logic_API::ProcessPacket(Packet_Frame& packet)
+{
+	// 로직 처리를 진행
+	sc_packet_result result;
+	result.packet_no = packet.packet_type;
 
-			}
-			break;
+	// Protocol Base값 을 가져온다.
+	ProtocolType protocolBase = (ProtocolType)((int)packet.packet_type / (int)PACKET_RANG_SIZE * (int)PACKET_RANG_SIZE);
 
-			case CLIENT_AUTH_BASE:
-			{
-				AuthRoute* auth = new AuthRoute();
-				auth->ApiProcessing(packet, result);
-				delete auth;
-			}
-			break;
+	// 각각의 Library로 처리를 보낸다.
+	switch (protocolBase) {
 
-			case CLIENT_FRONT_BASE:
-			{
+	case CLIENT_BASE:
+	{
 
-			}
-			break;
+	}
+	break;
 
-			case CLIENT_GOODS_BASE:
-			{
+	case CLIENT_AUTH_BASE:
+	{
+		AuthRoute* auth = new AuthRoute();
+		auth->ApiProcessing(packet, result);
+		delete auth;
+	}
+	break;
 
-			}
-			break;
+	case CLIENT_FRONT_BASE:
+	{
 
-			case CLIENT_INFO_BASE:
-			{
+	}
+	break;
 
-			}
-			break;
+	case CLIENT_GOODS_BASE:
+	{
 
-			default:
-				spdlog::error("ProcessPacket ProtocolType ({} / {})is not found..! || [unique_no:{}]", packet.packet_type, protocolBase, packet.unique_no);
-				break;
+	}
+	break;
 
-			}
+	case CLIENT_INFO_BASE:
+	{
 
-			// Result Packet 보내기.
-			if (result.result != (int)ResultCode::NONE) {
-				// Error의 경우에만 Msg발송 처리를 한다.
-				result.packet_len = sizeof(result);
-				result.packet_type = SERVER_RESULT_PACKET;
+	}
+	break;
 
-				spdlog::critical("Result Packet Error : {} || [unique_no:{}]", result.result, packet.unique_no);
-				epoll_server.SendPacket(result.unique_no, reinterpret_cast<char *>(&result), sizeof(result));
-			}
-			recvPacketQueue.pop();
-			delete[] packet.pMsg;
-		}
-		else {
-			std::this_thread::sleep_for(std::chrono::milliseconds(2));
-		}
+	default:
+		spdlog::error("ProcessPacket ProtocolType ({} / {})is not found..! || [unique_no:{}]", packet.packet_type, protocolBase, packet.unique_no);
+		break;
+
+	}
+
+	// Result Packet 보내기.
+	if (result.result != (int)ResultCode::NONE) {
+		// Error의 경우에만 Msg발송 처리를 한다.
+		result.packet_len = sizeof(result);
+		result.packet_type = SERVER_RESULT_PACKET;
+
+		spdlog::critical("Result Packet Error : {} || [unique_no:{}]", result.result, packet.unique_no);
+		epoll_server.SendPacket(packet.handle, reinterpret_cast<char *>(&result), sizeof(result));
 	}
+	delete[] packet.pMsg;
 }
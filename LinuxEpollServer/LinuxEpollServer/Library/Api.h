@@ -6,22 +6,41 @@
 #include "L_Auth.h"
 #include "../Module/M_Auth.h"
 
+#include <atomic>
+#include <chrono>
+
+#define MAX_API_BATCH 64	// API_Thread 한번에 꺼내는 Packet 수
+
+struct FRAME_View;
+class Chain_Buffer;
+
 class Logic_API {
 public:
 	bool start();
-	bool stop();
-	void packet_Add(int sock, unsigned_int64 unique_no, char* pMsg, unsigned short packetLen);
-	std::mutex& get_mutex() { return mLock; }
-	std::queue<Packet_Frame>& get_PacketFrame() { return recvPacketQueue; }
+	bool stop();	// shutdown_drain_sec 동안 Queue 에 남은 Packet 을 처리한다.
+	bool stop(const std::chrono::steady_clock::time_point deadline);	// deadline 까지 Queue 에 남은 Packet 을 처리한다.
+	void packet_Add(session_handle handle, int sock, unsigned_int64 unique_no, char* pMsg, unsigned short packetLen);
+	void packet_AddBatch(session_handle handle, int sock, unsigned_int64 unique_no, FRAME_View* frames, int frameCnt);	// OnRecv 에서 나눈 Packet 을 한번에 넣는다.
+	void packet_AddChain(session_handle handle, int sock, unsigned_int64 unique_no, Chain_Buffer& chain);	// 다 받은 큰 Packet 을 이어 붙여서 넣는다.
+	int get_shard_cnt() { return (int)mShards.size(); }
 	Logic_API();
 	~Logic_API();
 
 private:
-	bool threadRun;
-	std::thread api_thread;
-	std::queue<Packet_Frame> recvPacketQueue;
-	std::mutex	mLock;
-	void API_Thread();
+	// 세션 slot 으로 나눈 API_Thread (같은 세션의 Packet 은 항상 같은 shard 에서 순서대로 처리 된다)
+	struct LogicShard {
+		LockFreeQueue<Packet_Frame> recvPacketQueue;					// Worker(Reactor) -> API_Thread
+		std::thread api_thread;
+		int shardNo;
+	};
+	std::atomic<bool> threadRun;
+	std::chrono::steady_clock::time_point drainDeadline;				// 종료 요청 후 남은 Packet 처리 시한
+	std::vector<LogicShard *> mShards;									// LOGIC_CNT 개 (start 에서 생성)
+	LogicShard * get_shard(const session_handle handle) { return mShards[SESSION_HANDLE_SLOT(handle) % mShards.size()]; }
+	void API_Thread(LogicShard *pShard);								// WAIT_STRATEGY 로 Loop 선택
+	template <typename WaitPolicy>
+	void API_Loop(LogicShard *pShard);
+	void ProcessPacket(Packet_Frame& packet);							// 각각의 Library로 처리를 보낸다.
 };
 
 
@@ -9,6 +9,10 @@ AuthRoute::~AuthRoute()
 {
 }
 
+// 이동을 받을 주변 세션 (API Thread 별)
+static thread_local std::vector<session_handle> moveTargets;
+static thread_local std::vector<session_handle> moveTcpTargets;		// UDP 주소가 없는 세션
+
 void AuthRoute::ApiProcessing(Packet_Frame packet, sc_packet_result& resultCode)
 {
 	switch (packet.packet_type) {
@@ -30,37 +34,24 @@ void AuthRoute::ApiProcessing(Packet_Frame packet, sc_packet_result& resultCode)
 			}
 		}
 
-		// 유저 세션을 찾아온다.
-		auto pPlayerSession = epoll_server.getSessionByNo(packet.sock);
-		// 세션이 없을 경우 break 처리
-		if (pPlayerSession == nullptr) break;
-		pPlayerSession->set_unique_no(uniqueNo);
-
-		// 플레이어를 set 해준다.
-		class PLAYER * acceptPlayer = new class PLAYER;
-		acceptPlayer->set_sock(pPlayerSession->get_sock());
-		acceptPlayer->set_unique_no(uniqueNo);
-		player.insert(std::unordered_map<unsigned_int64, class PLAYER *>::value_type(uniqueNo, acceptPlayer));
-		// 기존 플레이어 del 해준다.
-		player.erase(olduniqueNo);
-
-		// 세션도 변경 처리 한다.
-		player_session.insert(std::unordered_map<unsigned_int64, class PLAYER_Session *>::value_type(uniqueNo, pPlayerSession));
-		player_session.erase(olduniqueNo);
-
-		// 사용한 tempUniqueNo는 다시 등록을 해준다.
-		epoll_server.add_tempUniqueNo(olduniqueNo);
+		// 세션, 플레이어 고유번호를 바꾸고 임시 uniqueNo 를 반납한다.
+		// 세션이 없거나 이미 종료 (재사용) 된 경우 break 처리 (임시 uniqueNo 는 ClosePlayer 에서 반납)
+		if (!epoll_server.ChangeUniqueNo(packet.handle, uniqueNo)) break;
 
 		// 클라이언트에게 자신의 고유번호를 전송해 준다.
+		session_handle handle = packet.handle;
 		sc_packet_unique_no packet;
 		packet.packet_type = SERVER_AUTH_UNIQUENO;
 		packet.packet_len = sizeof(packet);
 		packet.unique_no = uniqueNo;
-		epoll_server.SendPacket(uniqueNo, reinterpret_cast<char *>(&packet), sizeof(packet));
+		packet.udp_handle = handle;
+		packet.udp_token = udp.issue_token(handle);
+		packet.udp_port = udp.is_enabled() ? udp.get_port() : 0;
+		epoll_server.SendPacket(handle, reinterpret_cast<char *>(&packet), sizeof(packet));
 
 		resultCode.result = (int)ResultCode::NONE;
 		resultCode.unique_no = uniqueNo;
-		spdlog::info("[CLIENT_AUTH_LOGIN] Old uniqueNo : {} / Changed uniqueNo : {} || [unique_no:{}]", olduniqueNo, uniqueNo, pPlayerSession->get_unique_no());
+		spdlog::info("[CLIENT_AUTH_LOGIN] Old uniqueNo : {} / Changed uniqueNo : {} || [unique_no:{}]", olduniqueNo, uniqueNo, uniqueNo);
 	}
 	break;
 
@@ -68,6 +59,36 @@ void AuthRoute::ApiProcessing(Packet_Frame packet, sc_packet_result& resultCode)
 	{
 		spdlog::info("CLIENT_AUTH_TEST | sock : {}, unique_no : {}", packet.sock, packet.unique_no);
 		//std::cout << "CLIENT_AUTH_TEST" << " | " << packet.unique_no << std::endl;
+
+		// 이동 : 위치를 옮기고 주변 (AOI) 세션 에게만 보낸다.
+		auto pPlayer = epoll_server.getPlayerByHandle(packet.handle);
+		if (pPlayer == nullptr) break;
+		cs_packet_dir *my_packet = reinterpret_cast<cs_packet_dir *>(packet.pMsg);
+		int slot = (int)SESSION_HANDLE_SLOT(packet.handle);
+		Location position = aoi.is_entered(slot) ? pPlayer->get_position() : aoi.spawn_position(pPlayer->get_unique_no());
+		position.x += my_packet->dir.x;
+		position.y += my_packet->dir.y;
+		position = aoi.clamp(position);
+		pPlayer->set_position(position);
+		aoi.update(slot, packet.handle, position);
+
+		sc_packet_move movePacket;
+		movePacket.packet_type = SERVER_AUTH_MOVE;
+		movePacket.packet_len = sizeof(movePacket);
+		movePacket.unique_no = pPlayer->get_unique_no();
+		movePacket.position = position;
+		aoi.query(position, slot, moveTargets);
+		// UDP 주소를 받은 세션은 datagram 으로, 나머지는 TCP 로 보낸다.
+		udp.SendMove(moveTargets.data(), (int)moveTargets.size(), reinterpret_cast<char *>(&movePacket), sizeof(movePacket), moveTcpTargets);
+		if (!moveTcpTargets.empty()) {
+			epoll_server.BroadcastPacket(moveTcpTargets.data(), (int)moveTcpTargets.size(), reinterpret_cast<char *>(&movePacket), sizeof(movePacket));
+		}
+	}
+	break;
+
+	case CLIENT_AUTH_PONG:
+	{
+		// 수신 시간은 OnRecv 에서 갱신 되었다.
 	}
 	break;
 
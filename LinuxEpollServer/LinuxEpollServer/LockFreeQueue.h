@@ -0,0 +1,175 @@
+﻿#ifndef __LOCKFREEQUEUE_H__
+#define __LOCKFREEQUEUE_H__
+
+#include <atomic>
+#include <thread>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+#define MAX_QUEUE_SIZE 65536	// LockFreeQueue 기본 크기 (2의 제곱수)
+
+// 고정 크기 MPMC Queue (Dmitry Vyukov bounded queue)
+// Queue가 비어 있으면 소비자는 eventfd 에서 잠들고, 생산자가 push 할때 깨운다.
+// T는 memcpy 가능한 구조체 (epoll_event, Packet_Frame) 를 사용한다.
+template <typename T>
+class LockFreeQueue {
+public:
+	LockFreeQueue(const size_t size = MAX_QUEUE_SIZE) {
+		// size는 2의 제곱수로 맞춘다.
+		capacity = 1;
+		while (capacity < size) capacity <<= 1;
+		mask = capacity - 1;
+		cells = new Cell[capacity];
+		for (size_t i = 0; i < capacity; i++) {
+			cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+		enqueuePos.store(0, std::memory_order_relaxed);
+		dequeuePos.store(0, std::memory_order_relaxed);
+		waiters.store(0, std::memory_order_relaxed);
+		efd = eventfd(0, EFD_CLOEXEC);
+	}
+	~LockFreeQueue() {
+		delete[] cells;
+		cells = nullptr;
+		if (efd >= 0) close(efd);
+	}
+
+	// Queue가 가득 찼을 경우 false
+	bool tryPush(const T& data) {
+		if (!enqueue(data)) return false;
+		wakeIfWaiting();
+		return true;
+	}
+
+	// Queue가 가득 찼을 경우 소비자가 비울 때 까지 양보 후 재시도 한다.
+	void push(const T& data) {
+		while (!tryPush(data)) {
+			std::this_thread::yield();
+		}
+	}
+
+	// cnt 개를 넣은 뒤 잠든 소비자를 한번만 깨운다.
+	void pushBatch(const T* data, const int cnt) {
+		for (int i = 0; i < cnt; i++) {
+			while (!enqueue(data[i])) {
+				// 가득 찼다 -> 넣은 것 부터 처리 하도록 깨운다.
+				wakeIfWaiting();
+				std::this_thread::yield();
+			}
+		}
+		wakeIfWaiting();
+	}
+
+	bool tryPop(T& data) {
+		Cell* cell;
+		size_t pos = dequeuePos.load(std::memory_order_relaxed);
+		while (true) {
+			cell = &cells[pos & mask];
+			size_t seq = cell->sequence.load(std::memory_order_acquire);
+			intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+			if (diff == 0) {
+				if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+			}
+			else if (diff < 0) {
+				return false;
+			}
+			else {
+				pos = dequeuePos.load(std::memory_order_relaxed);
+			}
+		}
+		data = cell->data;
+		cell->sequence.store(pos + mask + 1, std::memory_order_release);
+		return true;
+	}
+
+	// 최대 maxCnt 개 를 꺼낸다. 비어 있으면 바로 0 을 반환한다. (Spin_Wait, Busy_Poll)
+	int tryPopBatch(T* out, const int maxCnt) {
+		int cnt = 0;
+		while (cnt < maxCnt && tryPop(out[cnt])) cnt++;
+		return cnt;
+	}
+
+	// 최대 maxCnt 개 를 한번에 꺼낸다. 비어 있으면 eventfd 에서 대기한다.
+	// notify() 로 깨워진 경우 0을 반환 할 수 있다.
+	int popBatch(T* out, const int maxCnt) {
+		int cnt = tryPopBatch(out, maxCnt);
+		if (cnt > 0) return cnt;
+
+		waiters.fetch_add(1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		// 잠들기 전에 다시 확인 하여 놓친 push 가 없도록 한다.
+		while (cnt < maxCnt && tryPop(out[cnt])) cnt++;
+		if (cnt == 0) {
+			uint64_t value;
+			if (read(efd, &value, sizeof value) < 0) {
+				// EINTR
+			}
+			while (cnt < maxCnt && tryPop(out[cnt])) cnt++;
+		}
+		waiters.fetch_sub(1, std::memory_order_relaxed);
+		return cnt;
+	}
+
+	// 대기중인 소비자를 깨운다. (종료 처리)
+	void notify() {
+		uint64_t value = 1;
+		if (write(efd, &value, sizeof value) < 0) {
+			// counter overflow (대기자가 이미 깨어 있다)
+		}
+	}
+
+	bool empty() {
+		size_t pos = dequeuePos.load(std::memory_order_relaxed);
+		return (intptr_t)cells[pos & mask].sequence.load(std::memory_order_acquire) - (intptr_t)(pos + 1) < 0;
+	}
+
+private:
+	// Cell 에 넣기만 한다. (깨우지 않는다)
+	bool enqueue(const T& data) {
+		Cell* cell;
+		size_t pos = enqueuePos.load(std::memory_order_relaxed);
+		while (true) {
+			cell = &cells[pos & mask];
+			size_t seq = cell->sequence.load(std::memory_order_acquire);
+			intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+			if (diff == 0) {
+				if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+			}
+			else if (diff < 0) {
+				return false;
+			}
+			else {
+				pos = enqueuePos.load(std::memory_order_relaxed);
+			}
+		}
+		cell->data = data;
+		cell->sequence.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	// 잠든 소비자가 있을 때만 eventfd write (syscall) 를 한다.
+	void wakeIfWaiting() {
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (waiters.load(std::memory_order_relaxed) > 0) {
+			notify();
+		}
+	}
+
+	struct Cell {
+		std::atomic<size_t> sequence;
+		T data;
+	};
+	Cell* cells;
+	size_t capacity;
+	size_t mask;
+	int efd;															// 소비자 대기용 eventfd
+	alignas(64) std::atomic<size_t> enqueuePos;
+	alignas(64) std::atomic<size_t> dequeuePos;
+	alignas(64) std::atomic<int> waiters;								// eventfd 에서 대기중인 소비자 수
+
+	LockFreeQueue(const LockFreeQueue&) = delete;
+	LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+};
+
+#endif
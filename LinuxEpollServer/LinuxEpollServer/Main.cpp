@@ -3,13 +3,29 @@
 class Logic_API api;
 class MySQLConnect sql;
 class ConfigSetting CS;
+class Buffer_Pool buffer_pool;
 class Epoll_Server epoll_server;
+class SERVER_Timer timer;
+class Hot_Restart hotRestart;
+class AOI_Grid aoi;
+class Udp_Channel udp;
+class Thread_Topology topology;
 std::vector<class RedisConnect *> RDC;
-std::unordered_map<int, class PLAYER *> player;
-std::unordered_map<int, class PLAYER_Session *> player_session;
 
 int main()
 {
+	// SIGTERM / SIGINT  signalfd  ޴´. (Thread    ƾ  Thread   ȴ)
+	sigset_t signalMask;
+	sigemptyset(&signalMask);
+	sigaddset(&signalMask, SIGTERM);
+	sigaddset(&signalMask, SIGINT);
+	pthread_sigmask(SIG_BLOCK, &signalMask, NULL);
+	int signalFd = signalfd(-1, &signalMask, SFD_CLOEXEC);
+	if (signalFd < 0) {
+		spdlog::error("signalfd() Function failure : {}", strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+
 #ifdef _RELEASE
 	// daily Logger Start 
 	// Debug 忡 ֿܼ ¸,   ʴ´.
@@ -26,17 +42,119 @@ int main()
 
 	// Start Server
 	CS.loadSettingData();																// Load Server Config
+	hotRestart.takeover(CS.get_hot_restart_path());										//     Ѱ ޴´. (Redis UNIQUE_NO б )
+	topology.init();																	// NUMA ޸ å (Thread  )
+	buffer_pool.init(CS.get_buffer_arena_mb(), CS.get_buffer_hugepage());				//  Buffer arena (NUMA å )
 	initRDC();																			// RedisClinet 
 	sql.init(CS.get_sql_host(), CS.get_sql_id(), CS.get_sql_pw(), CS.get_sql_db());		// DB init
+	timer.start();																		// timerfd init (EventThread   )
+	api.start();																		// API Thread init (LOGIC_CNT, I/O Thread  )
 	epoll_server.init_server();															// Server init
+	aoi.init_grid(CS.get_aoi_world_size(), CS.get_aoi_cell_size(), CS.get_aoi_view_range(), CS.get_max_player());	//  slot  AOI 
 	epoll_server.BindandListen(CS.get_server_port());									// Server BindListen
-	api.start();																		// API Thread init
+	udp.start(CS.get_udp_port());														// ̵ Packet UDP ä (UDP_PORT)
+	hotRestart.restore();																// Ѱ   
+	hotRestart.listen_handoff(CS.get_hot_restart_path());								//  μ  
 
-	// Shutdown protection
+	// signalfd, Hot Restart , ǥԷ   ٸ. (fd  -1 ̸ poll   ȴ)
+	struct pollfd mainFds[3];
+	mainFds[0].fd = signalFd;
+	mainFds[0].events = POLLIN;
+	mainFds[1].fd = hotRestart.get_fd();
+	mainFds[1].events = POLLIN;
+	mainFds[2].fd = STDIN_FILENO;
+	mainFds[2].events = POLLIN;
+	bool handedOff = false;
 	while (true) {
-		getchar();
+		for (auto& mainFd : mainFds) {
+			mainFd.revents = 0;
+		}
+		if (poll(mainFds, 3, -1) < 0) {
+			continue;
+		}
+		if (mainFds[0].revents & POLLIN) {
+			struct signalfd_siginfo info;
+			if (read(signalFd, &info, sizeof info) == sizeof info) {
+				spdlog::info("Signal ({}) received -> Server Shutdown", strsignal(info.ssi_signo));
+				break;
+			}
+		}
+		if (mainFds[1].revents & POLLIN) {
+			//  μ  ѱ. (ϸ I/O  ٽ Ͽ   Ѵ)
+			if (hotRestart.handoff() == HOT_DONE) {
+				handedOff = true;
+				break;
+			}
+		}
+		if (!(mainFds[2].revents & (POLLIN | POLLHUP))) {
+			continue;
+		}
+		char line[64];
+		if (fgets(line, sizeof line, stdin) == NULL) {
+			// ǥԷ   (daemon) signal  ٸ.
+			mainFds[2].fd = -1;
+			continue;
+		}
+		if (line[0] == 't') {
+			// Timing Wheel ó 
+			SERVER_Timer::benchmark(TIMER_BENCH_CNT);
+			continue;
+		}
+		if (line[0] == 'a') {
+			// AOI  ̵ / ȸ ó 
+			AOI_Grid::benchmark(10000);
+			AOI_Grid::benchmark(100000);
+			continue;
+		}
+		if (line[0] == 'r') {
+			// ReadBuffer  (  )  mirror 
+			ReadBuffer::benchmark(MAX_SOCKBUF, 100, 1448, MIN_SOCKBUF);
+			ReadBuffer::benchmark(MAX_SOCKBUF, 1000, 1448, MIN_SOCKBUF);
+			continue;
+		}
+		if (line[0] == 'p') {
+			// Buffer_Pool  / ֱ 
+			Buffer_Pool::benchmark(1000000);
+			continue;
+		}
+		if (line[0] == 'v') {
+			//  Buffer Ű Thread  Buffer   (recv ũⰡ Packet  ƴϸ  ´)
+			Epoll_Server::benchmarkRecv(1000, 100, 1448);
+			Epoll_Server::benchmarkRecv(10000, 100, 1448);
+			continue;
+		}
+		if (line[0] == 'b') {
+			// Broadcast ( Buffer)     
+			Epoll_Server::benchmarkBroadcast(1000, BROADCAST_BENCH_SIZE);
+			Epoll_Server::benchmarkBroadcast(10000, BROADCAST_BENCH_SIZE);
+			continue;
+		}
+		// Enter Է½ Worker / Reactor ó Ȳ Ѵ.
+		epoll_server.logWorkerStats();
+		epoll_server.logReactorStats();
+		epoll_server.logSendStats();
+		epoll_server.logAcceptStats();
+		epoll_server.logIdleStats();
+		epoll_server.logBackpressureStats();
+		epoll_server.logChainStats();
+		epoll_server.logMemoryStats();
+		epoll_server.logRecvStats();
+		aoi.logStats();
+		udp.logStats();
+		topology.logTopology();
+		timer.logStats();
+	}
+
+	// ,  ߴ -> Logic_API ó -> sendQueue  ->   (SHUTDOWN_DRAIN_SEC )
+	// Hot Restart  ѱ    μ ϹǷ  (shutdown) ʴ´.
+	if (!handedOff) {
+		epoll_server.Shutdown(CS.get_shutdown_drain_sec());
 	}
-    return 0;
+	timer.stop();
+	close(signalFd);
+	spdlog::info("Server Shutdown Complete..!");
+	spdlog::shutdown();
+	return 0;
 }
 
 void initRDC()
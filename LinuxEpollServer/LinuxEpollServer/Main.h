@@ -10,6 +10,9 @@
 #include <unordered_map>
 #include <queue>
 #include <pthread.h>
+#include <signal.h>
+#include <poll.h>
+#include <sys/signalfd.h>
 
 // SPDLog 1.5.0 <2020.01.21> github Include Add
 #include "includes/spdlog/spdlog.h"
@@ -21,21 +24,37 @@
 #include "Global/ResultCode.h"
 #include "Global/RedisConnect.h"
 #include "Global/MySQLConnect.h"
+#include "LockFreeQueue.h"
+#include "WaitPolicy.h"
+#include "PacketDecoder.h"
 #include "Library/Api.h"
+#include "BufferPool.h"
 #include "ReadBuffer.h"
+#include "ChainBuffer.h"
 #include "Object.h"
 #include "Session.h"
 #include "EpollServer.h"
+#include "SessionPool.h"
+#include "Reactor.h"
+#include "UringEngine.h"
+#include "Timer.h"
+#include "HotRestart.h"
+#include "AoiGrid.h"
+#include "UdpChannel.h"
+#include "ThreadTopology.h"
 
 // Setting Value
 extern class ConfigSetting CS;
 extern std::vector<class RedisConnect *> RDC;
 extern class MySQLConnect sql;
+extern class Buffer_Pool buffer_pool;
 extern class Epoll_Server epoll_server;
 extern class Logic_API api;
-//extern class SERVER_Timer timer;
-extern std::unordered_map<int, class PLAYER *> player;					// ÷̾ 
-extern std::unordered_map<int, class PLAYER_Session *> player_session;	// ÷̾ 
+extern class SERVER_Timer timer;
+extern class Hot_Restart hotRestart;
+extern class AOI_Grid aoi;
+extern class Udp_Channel udp;
+extern class Thread_Topology topology;
 
 void initRDC();
 #endif
\ No newline at end of file
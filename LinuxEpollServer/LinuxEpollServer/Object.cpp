@@ -18,4 +18,6 @@ void PLAYER::set_init_player()
 	connect = false;
 	live = false;
 	game_play = false;
+	position.x = 0;
+	position.y = 0;
 }
@@ -31,10 +31,12 @@ public:
 	// get
 	int get_sock() { return sock; }
 	unsigned_int64 get_unique_no() { return unique_no; }
+	Location get_position() { return position; }
 
 	// set
 	void set_sock(const int g_sock);
 	void set_unique_no(const unsigned_int64 id);
+	void set_position(const Location& pos) { position = pos; }
 	void set_init_player();
 
 private:
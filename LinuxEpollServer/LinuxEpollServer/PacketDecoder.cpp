@@ -0,0 +1,54 @@
+﻿#include "PacketDecoder.h"
+
+int PacketDecoder::decode(char* pData, const int size, FRAME_View* frames, const int maxFrames, int& readSize)
+{
+	int frameCnt = 0;
+	readSize = 0;
+	while (frameCnt < maxFrames && size - readSize >= PACKET_HEADER_BYTE) {
+		PACKET_HEADER header;
+		memcpy(&header, pData + readSize, sizeof(header));
+
+		// 크기 검사 : Header 보다 크고, MAX_PACKET_SIZE 보다 작고, Packet 종류 별 최소 크기 이상
+		int minSize = getMinSize(header.packet_type);
+		if (minSize < 0 || header.packet_len < minSize || header.packet_len > CS.get_max_packet_size()) {
+			return frameCnt > 0 ? frameCnt : DECODE_ERROR;
+		}
+
+		// ReadBuffer 보다 큰 Packet 은 여기서 멈춘다. (OnRecv 에서 Chain_Buffer 로 받는다)
+		if (header.packet_len > MAX_SOCKBUF) {
+			break;
+		}
+
+		// 아직 다 받지 못했다.
+		if (size - readSize < header.packet_len) {
+			break;
+		}
+
+		frames[frameCnt].pMsg = pData + readSize;
+		frames[frameCnt].size = header.packet_len;
+		frames[frameCnt].type = header.packet_type;
+		frameCnt++;
+		readSize += header.packet_len;
+	}
+	return frameCnt;
+}
+
+int PacketDecoder::getMinSize(const unsigned short packetType)
+{
+	switch (packetType) {
+	case CLIENT_AUTH_LOGIN:
+		return sizeof(cs_packet_auth);
+	case CLIENT_AUTH_TEST:
+		return sizeof(cs_packet_dir);
+	case CLIENT_AUTH_PONG:
+		return sizeof(cs_packet_pong);
+	default:
+		break;
+	}
+
+	// Body 가 정해지지 않은 Packet 은 Header 보다 크기만 하면 된다.
+	if (packetType >= CLIENT_BASE && packetType < MAX_CLIENT_PROTOCOL_NO) {
+		return PACKET_HEADER_BYTE + 1;
+	}
+	return -1;
+}
@@ -0,0 +1,27 @@
+﻿#ifndef __PACKET_DECODER_H__
+#define __PACKET_DECODER_H__
+
+#include "Main.h"
+
+#define MAX_FRAME_BATCH 64		// 한번에 나누는 Packet 수
+#define DECODE_ERROR -1			// 잘못된 Packet Header
+
+// ReadBuffer 안의 Packet 위치 (복사 하지 않는다)
+struct FRAME_View {
+	char* pMsg;
+	unsigned short size;
+	unsigned short type;
+};
+
+// ReadBuffer 를 한번 훑어서 완성된 Packet 을 모두 나눈다.
+// Header 를 복사 / lock 하지 않고 바로 읽으며, Packet 종류 별 최소 크기를 검사한다.
+class PacketDecoder {
+public:
+	// 완성된 Packet 수를 반환한다. (readSize : 나눈 전체 크기)
+	// 첫 Packet 부터 잘못된 경우 DECODE_ERROR, 중간에 잘못된 경우 그 앞까지만 반환한다.
+	// MAX_SOCKBUF 보다 큰 Packet 을 만나면 그 앞까지만 반환한다. (readSize 위치가 큰 Packet 의 Header)
+	static int decode(char* pData, const int size, FRAME_View* frames, const int maxFrames, int& readSize);
+	static int getMinSize(const unsigned short packetType);			// -1 : Client 가 보낼 수 없는 Packet
+};
+
+#endif
@@ -7,7 +7,7 @@ typedef unsigned long long int	unsigned_int64;	// 8Byte, 64bit
 
 #define TEMP_UNIQUE_NO 0		// 임시 고유번호
 #define UNIQUE_START_NO 10000	// 고유번호 시작
-#define MAX_SOCKBUF	 4096		// 최대 패킷 사이즈
+#define MAX_SOCKBUF	 4096		// 최대 패킷 사이즈 (수신 Buffer 크기, 이보다 큰 Packet 은 Chain_Buffer 로 받는다)
 #define MIN_SOCKBUF 128			// 최소 패킷 사이즈
 #define MAX_WORKERTHREAD 9		// 쓰레드 풀에 넣을 쓰레드 수
 #define PACKET_HEADER_BYTE 4	// Packet Header 크기
@@ -44,6 +44,7 @@ enum ProtocolType {
 	CLIENT_AUTH_TEST2,
 	CLIENT_AUTH_TEST3,
 	CLIENT_AUTH_TEST4,
+	CLIENT_AUTH_PONG,
 
 	// Front
 	CLIENT_FRONT = CLIENT_FRONT_BASE,
@@ -75,6 +76,8 @@ enum ProtocolType {
 	// Auth
 	SERVER_AUTH = SERVER_AUTH_BASE,
 	SERVER_AUTH_UNIQUENO,
+	SERVER_AUTH_PING,
+	SERVER_AUTH_MOVE,
 
 	// Front
 	SERVER_FRONT = SERVER_FRONT_BASE,
@@ -102,20 +105,56 @@ struct PACKET_HEADER {
 	unsigned short packet_type;
 };
 
+// 세션 핸들 : 상위 32bit generation, 하위 32bit Session_Pool slot
+// 세션이 종료 / 재사용 되면 generation 이 바뀌어 늦게 도착한 응답은 버려진다.
+typedef unsigned_int64 session_handle;
+#define INVALID_SESSION_HANDLE 0
+#define MAKE_SESSION_HANDLE(gen, slot) (((unsigned_int64)(gen) << 32) | (unsigned int)(slot))
+#define SESSION_HANDLE_GEN(handle) ((unsigned int)((handle) >> 32))
+#define SESSION_HANDLE_SLOT(handle) ((int)((handle) & 0xffffffff))
+
 struct Packet_Frame {
 	unsigned short packet_type = -1; // NONE
 	unsigned short size = 0;
+	session_handle handle = INVALID_SESSION_HANDLE;
 	int sock = 0;
 	unsigned_int64 unique_no = 0;
 	char* pMsg = nullptr;
 };
 
+// UDP datagram 앞 부분 (뒤에 Packet 1개가 이어진다)
+// 클라 -> 서버 : 로그인 때 받은 handle, token 으로 세션을 찾는다.
+// 서버 -> 클라 : handle 은 받는 세션, token 은 0
+// seq 는 보내는 쪽 마다 1 부터 증가하고, 받는 쪽은 마지막 seq 이하를 (늦게 도착한 이동) 버린다.
+struct UDP_HEADER {
+	session_handle handle;
+	unsigned_int64 token;
+	unsigned int seq;
+	unsigned int reserved;
+};
+
 // 타이머 타입
 enum TimerType {
 	T_NormalTime,
-	T_DisconnectRemove
+	T_DisconnectRemove,
+	T_IdleCheck					// 세션 유휴 검사 (IDLE_TIMEOUT_SEC, PING_INTERVAL_SEC)
 };
 
+// Thread 역할 ([Threads] 의 *_CPU)
+enum THREAD_ROLE {
+	THREAD_EVENT,		// EventThread (accept, epoll 분배) / io_uring Engine
+	THREAD_WORKER,		// WorkerThread
+	THREAD_REACTOR,		// Reactor
+	THREAD_LOGIC,		// Logic_API shard (Redis 호출 포함)
+	THREAD_UDP,			// UDP 수신
+	MAX_THREAD_ROLE
+};
+
+// 타이머 ID : 상위 32bit generation, 하위 32bit node 위치
+// 이미 실행 / 취소된 타이머를 cancel 하면 generation 비교로 무시 된다.
+typedef unsigned_int64 timer_id;
+#define INVALID_TIMER_ID 0
+
 // ↓ 클라 -> 서버 패킷
 struct cs_packet_auth : public PACKET_HEADER {
 	char sha256sum[MIN_SOCKBUF]{ 0, };
@@ -125,6 +164,10 @@ struct cs_packet_dir : public PACKET_HEADER {
 	Location dir;
 };
 
+struct cs_packet_pong : public PACKET_HEADER {
+	unsigned_int64 server_tick;		// 받은 sc_packet_ping 값
+};
+
 struct cs_packet_test : public PACKET_HEADER {
 	int tp;
 	int cp;
@@ -135,6 +178,13 @@ struct cs_packet_test : public PACKET_HEADER {
 // ↓ 서버 -> 클라 패킷
 struct sc_packet_unique_no : public PACKET_HEADER {
 	uint64_t unique_no;
+	session_handle udp_handle;		// UDP datagram 에 넣을 세션 핸들
+	unsigned_int64 udp_token;		// UDP datagram 에 넣을 인증 값
+	int udp_port;					// 이동 Packet UDP 포트 (0 : 사용 안함)
+};
+
+struct sc_packet_ping : public PACKET_HEADER {
+	unsigned_int64 server_tick;
 };
 
 struct sc_packet_result : public PACKET_HEADER {
@@ -147,4 +197,9 @@ struct sc_packet_dir : public PACKET_HEADER {
 	Location dir;
 };
 
+struct sc_packet_move : public PACKET_HEADER {
+	unsigned_int64 unique_no;		// 이동한 플레이어
+	Location position;				// 이동 후 위치
+};
+
 #endif
\ No newline at end of file
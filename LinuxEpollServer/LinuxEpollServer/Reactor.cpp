@@ -0,0 +1,183 @@
+﻿#include "Reactor.h"
+
+Epoll_Reactor::Epoll_Reactor(const int reactorNo)
+{
+	this->reactorNo = reactorNo;
+	epfd = -1;
+	listenSock = -1;
+	wakeFd = -1;
+	sessionCnt = 0;
+	acceptCnt = 0;
+	mIsReactorRun = false;
+	events.resize(MAX_EVENTS);
+}
+
+Epoll_Reactor::~Epoll_Reactor()
+{
+	if (wakeFd >= 0) {
+		close(wakeFd);
+	}
+}
+
+bool Epoll_Reactor::init_reactor(int port)
+{
+	if ((epfd = epoll_create(MAX_EVENTS)) < 0) {
+		spdlog::error("[Reactor:{}] epoll_create() Function failure", reactorNo);
+		return false;
+	}
+	if ((wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0) {
+		spdlog::error("[Reactor:{}] eventfd() Function failure", reactorNo);
+		return false;
+	}
+	epoll_server.AddEventFd(epfd, wakeFd);
+
+	// Hot Restart 로 넘겨 받은 Listen 소켓은 이미 bind, listen 되어 있다.
+	listenSock = hotRestart.take_listen_sock();
+	if (listenSock < 0 && !open_listen(port)) {
+		return false;
+	}
+
+	struct epoll_event ev;
+	memset(&ev, 0, sizeof ev);
+	ev.events = EPOLLIN | EPOLLEXCLUSIVE;
+	ev.data.fd = listenSock;
+	epoll_ctl(epfd, EPOLL_CTL_ADD, listenSock, &ev);
+	return true;
+}
+
+bool Epoll_Reactor::open_listen(int port)
+{
+	if ((listenSock = socket(PF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)) < 0) {
+		spdlog::error("[Reactor:{}] socket() Function failure", reactorNo);
+		return false;
+	}
+
+	// 같은 포트를 Reactor 수 만큼 Bind 하여 커널이 연결을 분배하도록 한다.
+	int option = 1;
+	setsockopt(listenSock, SOL_SOCKET, SO_REUSEADDR, &option, sizeof option);
+	if (setsockopt(listenSock, SOL_SOCKET, SO_REUSEPORT, &option, sizeof option) < 0) {
+		spdlog::error("[Reactor:{}] setsockopt(SO_REUSEPORT) Function failure : {}", reactorNo, strerror(errno));
+		return false;
+	}
+
+	struct sockaddr_in sin;
+	memset(&sin, 0, sizeof sin);
+	sin.sin_family = AF_INET;
+	sin.sin_addr.s_addr = htonl(INADDR_ANY);
+	sin.sin_port = htons(port);
+
+	if (bind(listenSock, (struct sockaddr *) &sin, sizeof sin) < 0) {
+		spdlog::error("[Reactor:{}] bind() Function failure", reactorNo);
+		return false;
+	}
+
+	if (!epoll_server.ListenSocket(listenSock)) {
+		spdlog::error("[Reactor:{}] listen() Function failure", reactorNo);
+		return false;
+	}
+	return true;
+}
+
+void Epoll_Reactor::start()
+{
+	mIsReactorRun = true;
+	mReactorThread = std::thread([this]() { ReactorThread(); });
+}
+
+void Epoll_Reactor::stop()
+{
+	mIsReactorRun = false;
+}
+
+void Epoll_Reactor::join()
+{
+	if (mReactorThread.joinable()) {
+		mReactorThread.join();
+	}
+}
+
+void Epoll_Reactor::close_listen()
+{
+	if (listenSock >= 0) {
+		close(listenSock);
+		listenSock = -1;
+	}
+}
+
+bool Epoll_Reactor::requestClose(const session_handle handle)
+{
+	// 타이머를 실행하는 Reactor (0) 자신의 세션은 바로 닫는다. (자기 Queue 를 기다리면 멈춘다)
+	if (is_reactor_thread()) {
+		epoll_server.ClosePlayer(handle);
+		return true;
+	}
+	// 세션은 Reactor Thread 만 닫으므로 Queue 에 넣고 깨운다.
+	if (!closeQueue.tryPush(handle)) {
+		return false;
+	}
+	uint64_t value = 1;
+	if (write(wakeFd, &value, sizeof value) < 0) {
+		// counter overflow (이미 깨어 있다)
+	}
+	return true;
+}
+
+void Epoll_Reactor::ReactorThread()
+{
+	topology.bind_thread(THREAD_REACTOR, reactorNo);
+	switch (CS.get_wait_strategy()) {
+	case WAIT_SPIN:
+		ReactorLoop<Spin_Wait>();
+		break;
+	case WAIT_BUSY_POLL:
+		ReactorLoop<Busy_Poll>();
+		break;
+	default:
+		ReactorLoop<Block_Wait>();
+		break;
+	}
+}
+
+template <typename WaitPolicy>
+void Epoll_Reactor::ReactorLoop()
+{
+	WaitPolicy wait(CS.get_spin_usec());
+	int nfds;
+	while (mIsReactorRun)
+	{
+		nfds = wait.wait_epoll(epfd, events.data(), MAX_EVENTS);
+		if (nfds <= 0) {
+			continue;
+		}
+
+		for (int i = 0; i < nfds; i++) {
+			if (events[i].data.fd == listenSock) {
+				// 신규 유저 접속 처리
+				epoll_server.AcceptProcessing(listenSock, reactorNo);
+			}
+			else if (events[i].data.fd == timer.get_fd()) {
+				// 만료된 타이머 처리 (Reactor 0)
+				timer.OnTick();
+			}
+			else if (events[i].data.fd == epoll_server.get_shutdown_fd()) {
+				// 종료 요청 (mIsReactorRun 확인)
+				continue;
+			}
+			else if (events[i].data.fd == wakeFd) {
+				// 다른 Thread 에서 요청한 세션 종료
+				uint64_t value;
+				if (read(wakeFd, &value, sizeof value) < 0) {
+					// EAGAIN
+				}
+				session_handle handle;
+				while (closeQueue.tryPop(handle)) {
+					epoll_server.ClosePlayer(handle);
+				}
+			}
+			else {
+				// 공유 Queue 없이 Reactor Thread에서 바로 처리 한다.
+				epoll_server.EventProcessing(events[i]);
+			}
+		}
+	}
+}
@@ -0,0 +1,54 @@
+﻿#ifndef __REACTOR_H__
+#define __REACTOR_H__
+
+#include "Main.h"
+
+#include <atomic>
+#include <sys/epoll.h>
+#include <netinet/in.h>
+
+#define REACTOR_CLOSE_QUEUE 4096	// Reactor 별 세션 종료 요청 Queue 크기
+
+// Reactor 하나가 자신의 epoll, SO_REUSEPORT Listen 소켓, 세션을 모두 가진다.
+// accept -> read -> parse -> send 를 Reactor Thread 안에서 처리하여 공유 Queue 없이 코어 수 만큼 확장한다.
+class Epoll_Reactor {
+public:
+	Epoll_Reactor(const int reactorNo);
+	~Epoll_Reactor();
+	bool init_reactor(int port);											// epoll 생성, Listen 소켓 Bind
+	void start();
+	void stop();														// 종료 요청 (shutdown eventfd 로 깨운다)
+	void join();														// Thread 종료 대기
+	void close_listen();												// Listen 소켓 닫기
+	bool requestClose(const session_handle handle);						// 세션 종료 요청 (Queue 가 가득 차면 false)
+
+	// get
+	int get_reactor_no() { return reactorNo; }
+	bool is_reactor_thread() { return std::this_thread::get_id() == mReactorThread.get_id(); }
+	int get_epfd() { return epfd; }
+	int get_listen_sock() { return listenSock; }
+	int get_session_cnt() { return sessionCnt.load(); }
+	unsigned_int64 get_accept_cnt() { return acceptCnt.load(); }
+
+	// set
+	void incr_session_cnt() { sessionCnt++; acceptCnt++; }
+	void decr_session_cnt() { sessionCnt--; }
+
+private:
+	int reactorNo;
+	int epfd;															// Reactor 전용 epoll
+	int listenSock;														// SO_REUSEPORT Listen 소켓
+	std::vector<struct epoll_event> events;
+	std::atomic<int> sessionCnt;										// 현재 연결 수
+	std::atomic<unsigned_int64> acceptCnt;								// 누적 accept 수
+	LockFreeQueue<session_handle> closeQueue{ REACTOR_CLOSE_QUEUE };	// 세션 종료 요청
+	int wakeFd;															// closeQueue 요청 알림 eventfd
+	bool mIsReactorRun;
+	std::thread mReactorThread;
+	bool open_listen(int port);											// SO_REUSEPORT Listen 소켓 생성, Bind
+	void ReactorThread();												// Reactor Thread Function (WAIT_STRATEGY 로 Loop 선택)
+	template <typename WaitPolicy>
+	void ReactorLoop();
+};
+
+#endif
@@ -1,129 +1,239 @@
-#include "ReadBuffer.h"
+#include "Main.h"
+
+#include <chrono>
+#include <vector>
+#include <atomic>
+#include <unistd.h>
 
 char first_packet{ 0 };
 
-ReadBuffer::ReadBuffer()
+template <typename LockPolicy>
+Basic_ReadBuffer<LockPolicy>::Basic_ReadBuffer()
 {
 	totalSize = 0;
 	readPos = 0;
 }
 
-ReadBuffer::~ReadBuffer()
+template <typename LockPolicy>
+Basic_ReadBuffer<LockPolicy>::~Basic_ReadBuffer()
 {
-	delete[] buffer;
-	buffer = nullptr;
+	release();
 }
 
-void ReadBuffer::init(int size)
+template <typename LockPolicy>
+void Basic_ReadBuffer<LockPolicy>::init(int size, bool mirror)
 {
-	std::lock_guard<std::mutex> guard(mLock);
-	totalSize = size;
-	buffer = new char[size];
-	memset(buffer, 0, totalSize);
+	std::lock_guard<LockPolicy> guard(mLock);
+	release();
 	readPos = 0;
 	writePos = 0;
+	compactBytes = 0;
+	mirrorWanted = mirror;
+	if (mirror) {
+		// page ũ θ ̾ map   ִ.
+		int pageSize = (int)sysconf(_SC_PAGESIZE);
+		size = (size + pageSize - 1) / pageSize * pageSize;
+	}
+	totalSize = size;
 }
 
-int ReadBuffer::getHeaderSize(char* pMsg, int size)
+template <typename LockPolicy>
+bool Basic_ReadBuffer<LockPolicy>::acquire()
 {
-	std::lock_guard<std::mutex> guard(mLock);
+	if (buffer != nullptr) {
+		return true;
+	}
+	if (mirrorWanted) {
+		buffer = buffer_pool.alloc_mirror(totalSize);
+		if (buffer != nullptr) {
+			mirrored = true;
+			return true;
+		}
+		// vm.max_map_count, memfd  ... ѹ ϰ  Buffer  Ѵ.
+		static std::atomic<bool> failLogged{ false };
+		if (!failLogged.exchange(true)) {
+			spdlog::error("ReadBuffer mirror map failure : {} -> linear buffer", strerror(errno));
+		}
+		mirrorWanted = false;
+	}
+	buffer = buffer_pool.alloc(totalSize);
+	return buffer != nullptr;
+}
 
-	// ̰ ߸ Ŵ
-	if (totalSize - readPos < size) {
-		return -1;
+template <typename LockPolicy>
+void Basic_ReadBuffer<LockPolicy>::release()
+{
+	if (buffer == nullptr) {
+		return;
 	}
-	// Packet_Header Size ŭ pMsg(Packet_Header) Ѵ.
-#ifdef _MSC_VER
-	memcpy_s(pMsg, size, &buffer[readPos], size);
-#else
-	memcpy(pMsg, &buffer[readPos], size);
-#endif
+	if (mirrored) {
+		buffer_pool.release_mirror(buffer, totalSize);
+	}
+	else {
+		buffer_pool.release(buffer, totalSize);
+	}
+	buffer = nullptr;
+	mirrored = false;
+}
 
-	return size;
+template <typename LockPolicy>
+void Basic_ReadBuffer<LockPolicy>::releaseIfEmpty()
+{
+	std::lock_guard<LockPolicy> guard(mLock);
+	// ϼ  Packet      ִ´.
+	if (writePos == readPos) {
+		readPos = 0;
+		writePos = 0;
+		release();
+	}
 }
 
-int ReadBuffer::setWriteBuffer(char * pMsg, int size)
+template <typename LockPolicy>
+void Basic_ReadBuffer<LockPolicy>::clear()
 {
-	std::lock_guard<std::mutex> guard(mLock);
+	std::lock_guard<LockPolicy> guard(mLock);
+	readPos = 0;
+	writePos = 0;
+	release();
+}
 
-	//   , size ũ ʱȭ ش.
+template <typename LockPolicy>
+int Basic_ReadBuffer<LockPolicy>::setWriteBuffer(char * pMsg, int size)
+{
+	std::lock_guard<LockPolicy> guard(mLock);
+	if (!acquire()) {
+		return -1;
+	}
+
+	//  ( ) ͸  ʴ´. ȣ   ´.
 	if (size > getWriteAbleSize()) {
-#ifdef _MSC_VER
-		memcpy_s(&buffer[0], size, pMsg, size);
-#else
-		memcpy(&buffer[0], pMsg, size);
-#endif
-		readPos = 0;
-		writePos = size;
+		spdlog::critical("setWriteBuffer size({}) > WriteAbleSize({})", size, getWriteAbleSize());
+		return -1;
 	}
-	else {
 #ifdef _MSC_VER
-		memcpy_s(&buffer[writePos], size, pMsg, size);
+	memcpy_s(&buffer[writePos], size, pMsg, size);
 #else
-		memcpy(&buffer[writePos], pMsg, size);
+	memcpy(&buffer[writePos], pMsg, size);
 #endif
-		writePos += size;
-	}
+	writePos += size;
 	return size;
 }
 
 // 
-bool ReadBuffer::moveWritePos(int size)
+template <typename LockPolicy>
+bool Basic_ReadBuffer<LockPolicy>::moveWritePos(int size)
 {
-	std::lock_guard<std::mutex> guard(mLock);
+	std::lock_guard<LockPolicy> guard(mLock);
 
-	// totalSize ū Ŷ ø .
-	if (size > totalSize) {
-		spdlog::critical("moveWritePos size({}) > totalSize({})", size, totalSize);
+	//       .
+	if (size > getWriteAbleSize()) {
+		spdlog::critical("moveWritePos size({}) > WriteAbleSize({})", size, getWriteAbleSize());
 		return false;
 	}
-	writePos = (writePos + size) % totalSize;
+	//  : Packet   ʵ  ȯ ʴ´. (checkWrite   )
+	// mirror :  Ѿ κ  map  ״  ִ.
+	writePos += size;
 	return true;
 }
 
-void ReadBuffer::moveReadPos(int size)
+template <typename LockPolicy>
+void Basic_ReadBuffer<LockPolicy>::moveReadPos(int size)
 {
-	std::lock_guard<std::mutex> guard(mLock);
-	readPos = (readPos + size) % totalSize;
+	std::lock_guard<LockPolicy> guard(mLock);
+	readPos += size;
+	//  о ó  ٽ .
+	if (readPos >= writePos) {
+		readPos = 0;
+		writePos = 0;
+	}
+	else if (mirrored && readPos >= totalSize) {
+		//  map  Ѿ  ġ  map  ű. ( )
+		readPos -= totalSize;
+		writePos -= totalSize;
+	}
 }
 
-int ReadBuffer::getReadAbleSize(void)
+template <typename LockPolicy>
+int Basic_ReadBuffer<LockPolicy>::getReadAbleSize(void)
 {
-	if (readPos <= writePos) {
-		return writePos - readPos;
-	}
-	else {
-		return (totalSize - readPos) + writePos;
-	}
+	return writePos - readPos;
 }
 
-int ReadBuffer::getWriteAbleSize(void)
+template <typename LockPolicy>
+int Basic_ReadBuffer<LockPolicy>::getWriteAbleSize(void)
 {
-	if (readPos > writePos)
-	{
-		return readPos - writePos;
-	}
-	else
-	{
-		return totalSize - writePos;
+	if (mirrored) {
+		return totalSize - (writePos - readPos);
 	}
+	return totalSize - writePos;
 }
 
-void ReadBuffer::checkWrite(int size)
+template <typename LockPolicy>
+void Basic_ReadBuffer<LockPolicy>::checkWrite(int size)
 {
-	std::lock_guard<std::mutex> guard(mLock);
+	std::lock_guard<LockPolicy> guard(mLock);
+	// ޱ  Buffer  .
+	acquire();
 
-	// ȯ
-	if (writePos + size >= totalSize)
-	{
-#ifdef _MSC_VER
-		memcpy_s(buffer, writePos - readPos,
-			&buffer[readPos], writePos - readPos);
-#else
-		memcpy(buffer, &buffer[readPos], writePos - readPos);
-#endif
+	// mirror    ׻ ̾ ִ.
+	if (mirrored) {
+		return;
+	}
 
-		readPos = 0;
+	//    size    ͸  .
+	if (totalSize - writePos < size && readPos > 0)
+	{
+		// ġ ̹Ƿ memmove  Ѵ.
+		memmove(buffer, &buffer[readPos], writePos - readPos);
+		compactBytes += writePos - readPos;
 		writePos = writePos - readPos;
+		readPos = 0;
 	}
 }
+
+// LockPolicy, mirror ϳ  Ѵ.
+template <typename LockPolicy>
+static void benchmarkRun(const char* lockName, const bool mirror, const int bufferSize, const int packetSize, const int recvSize, const int minRoom)
+{
+	//   EventProcessing    (checkWrite -> read -> moveWritePos -> Packet  -> moveReadPos)  Ѵ.
+	// recvSize  packetSize   ƴϸ Ź Packet Ϻΰ Ƽ  Buffer    簡 .
+	const long long totalBytes = 256LL * 1024 * 1024;
+	std::vector<char> recvData(recvSize, 'r');
+	Basic_ReadBuffer<LockPolicy> readBuffer;
+	readBuffer.init(bufferSize, mirror);
+	long long recvBytes = 0;
+	long long packetCnt = 0;
+	unsigned int checkSum = 0;
+	auto begin = std::chrono::steady_clock::now();
+	while (recvBytes < totalBytes) {
+		readBuffer.checkWrite(minRoom);
+		int ioSize = std::min(recvSize, readBuffer.getWriteAbleSize());
+		memcpy(readBuffer.getWriteBuffer(), recvData.data(), ioSize);
+		readBuffer.moveWritePos(ioSize);
+		recvBytes += ioSize;
+		while (readBuffer.getReadAbleSize() >= packetSize) {
+			// Packet  ó,  д´. ( Ѿ Packet  ̾ д´)
+			checkSum += (unsigned char)readBuffer.getReadBuffer()[0] + (unsigned char)readBuffer.getReadBuffer()[packetSize - 1];
+			readBuffer.moveReadPos(packetSize);
+			packetCnt++;
+		}
+	}
+	double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+	spdlog::info("[ReadBuffer Bench] {} / {} (size {}) packet : {} byte, recv : {} byte, ns/packet : {:.1f}, MB/sec : {:.0f}, compact copy : {} MB (checksum {})",
+		lockName, readBuffer.is_mirrored() ? "mirror" : "linear", readBuffer.get_total_size(), packetSize, recvSize,
+		packetCnt > 0 ? sec * 1e9 / packetCnt : 0.0, sec > 0 ? recvBytes / sec / (1024 * 1024) : 0.0,
+		readBuffer.get_compact_bytes() / (1024 * 1024), checkSum);
+}
+
+template <typename LockPolicy>
+void Basic_ReadBuffer<LockPolicy>::benchmark(const int bufferSize, const int packetSize, const int recvSize, const int minRoom)
+{
+	//   (std::mutex)    Buffer (No_Lock) 
+	benchmarkRun<std::mutex>("mutex", false, bufferSize, packetSize, recvSize, minRoom);
+	benchmarkRun<std::mutex>("mutex", true, bufferSize, packetSize, recvSize, minRoom);
+	benchmarkRun<No_Lock>("no lock", false, bufferSize, packetSize, recvSize, minRoom);
+	benchmarkRun<No_Lock>("no lock", true, bufferSize, packetSize, recvSize, minRoom);
+}
+
+template class Basic_ReadBuffer<No_Lock>;
+template class Basic_ReadBuffer<std::mutex>;
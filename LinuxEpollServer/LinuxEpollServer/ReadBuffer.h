@@ -5,13 +5,29 @@
 #include <string.h>
 #include "includes/spdlog/spdlog.h"
 
-class ReadBuffer {
+// 수신 Buffer
+// Buffer 는 처음 쓸 때 Buffer_Pool 에서 빌리고, releaseIfEmpty 에서 다 읽었으면 돌려준다. (유휴 세션은 Buffer 가 없다)
+// mirror : 같은 memfd 를 연속된 주소에 두번 map 하여 (buffer[i] == buffer[i + totalSize])
+//          끝에서 넘어가는 Packet 도 항상 이어진 메모리로 읽고 쓴다. (앞으로 당기는 복사가 없다)
+// 선형 : mirror 를 쓰지 않거나 실패한 경우, 뒤쪽 공간이 부족하면 checkWrite 에서 앞으로 당긴다.
+// LockPolicy : lock() / unlock() 을 가진 타입 (No_Lock, std::mutex)
+
+// 한 Thread 만 사용하는 Buffer 는 Lock 을 하지 않는다. (호출이 없어진다)
+struct No_Lock {
+	void lock() {}
+	void unlock() {}
+};
+
+template <typename LockPolicy>
+class Basic_ReadBuffer {
 public:
-	ReadBuffer();
-	~ReadBuffer();
-	void init(int size);
-	int getHeaderSize(char* pMsg, int size);
-	int setWriteBuffer(char* pMsg, int size);
+	Basic_ReadBuffer();
+	~Basic_ReadBuffer();
+	void init(int size, bool mirror = false);					// 크기만 정한다. (mirror 는 page 크기 단위로 올린다)
+	void clear();												// 세션 재사용시 위치 초기화, Buffer 반납
+	bool acquire();												// Buffer 가 없으면 Pool 에서 빌린다.
+	void releaseIfEmpty();										// 남은 데이터가 없으면 Pool 로 돌려준다.
+	int setWriteBuffer(char* pMsg, int size);					// 실패 -1 (Buffer 를 빌리지 못했거나 공간이 부족하다)
 	char * getReadBuffer(void) { return &buffer[readPos]; }
 	char * getWriteBuffer(void) { return &buffer[writePos]; }
 	bool moveWritePos(int size);
@@ -21,13 +37,28 @@ public:
 	void checkWrite(int size);
 	int getReadPos() { return readPos; }
 	int getWritePos() { return writePos; }
+	bool is_mirrored() { return mirrored; }
+	bool is_acquired() { return buffer != nullptr; }
+	int get_total_size() { return totalSize; }
+	long long get_compact_bytes() { return compactBytes; }
+	static void benchmark(const int bufferSize, const int packetSize, const int recvSize, const int minRoom);	// Lock 정책, 선형 / mirror 처리량 비교
 
 private:
-	char* buffer;
+	char* buffer = nullptr;
 	int totalSize = 0;
-	int readPos = 0;
-	int writePos = 0;
-	std::mutex	mLock;
+	int readPos = 0;											// mirror : 0 ~ totalSize - 1
+	int writePos = 0;											// mirror : readPos ~ readPos + totalSize
+	bool mirrored = false;
+	bool mirrorWanted = false;									// init 에서 mirror 를 요청 하였는가
+	long long compactBytes = 0;									// checkWrite 에서 앞으로 당긴 byte (누적)
+	LockPolicy	mLock;
+	void release();												// Pool 로 반납
 };
 
-#endif
\ No newline at end of file
+// 세션 수신 Buffer : fd 를 가진 I/O Thread (Worker, Reactor, Uring) 만 사용한다.
+// 세션 초기화 (accept), Hot Restart 복사는 I/O 등록 전 / Thread 종료 후에 한다.
+typedef Basic_ReadBuffer<No_Lock> ReadBuffer;
+// 여러 Thread 가 같이 사용하는 경우
+typedef Basic_ReadBuffer<std::mutex> Shared_ReadBuffer;
+
+#endif
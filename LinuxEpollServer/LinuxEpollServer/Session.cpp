@@ -1,14 +1,90 @@
 ﻿#include "Session.h"
 
+PLAYER_Session::PLAYER_Session()
+{
+	m_readBuffer.init(MAX_SOCKBUF, CS.get_read_buffer_mirror());
+	pChain = nullptr;
+	m_socketSession = INVALID_SOCKET;
+	unique_no = 0;
+	error_cnt = 0;
+	reactor_no = -1;
+	slot_no = -1;
+	handle = INVALID_SESSION_HANDLE;
+	lastActiveTick = 0;
+	idleTimer = INVALID_TIMER_ID;
+	sendOffset = 0;
+	sendPendingSize = 0;
+	sendArmed = false;
+	sendDirty = false;
+	queuedFrames = 0;
+	readPaused = false;
+	pauseCnt = 0;
+	udpToken = 0;
+	udpRecvSeq = 0;
+	udpSendSeq = 0;
+	udpBound = false;
+	memset(&udpAddr, 0, sizeof(udpAddr));
+}
+
 void PLAYER_Session::set_unique_no(const unsigned_int64 id)
 {
-	unique_no = id;
+	unique_no.store(id, std::memory_order_relaxed);
 }
 
 void PLAYER_Session::set_init_session()
 {
 	m_socketSession = INVALID_SOCKET;
 	unique_no = 0;
+	error_cnt = 0;
+	reactor_no = -1;
+	m_readBuffer.clear();
+	end_chain();
+	queuedFrames = 0;
+	// 이전 핸들로 SendPacket / FlushSendAll 중인 Thread 와 같이 sendQueue 를 사용한다.
+	std::lock_guard<std::mutex> guard(mSendLock);
+	clear_sendQueue();
+	readPaused = false;
+	pauseCnt = 0;
+	set_udp_token(0);
+}
+
+Chain_Buffer * PLAYER_Session::begin_chain(const int frameSize)
+{
+	end_chain();
+	pChain = new Chain_Buffer(frameSize);
+	return pChain;
+}
+
+void PLAYER_Session::end_chain()
+{
+	if (pChain != nullptr) {
+		delete pChain;
+		pChain = nullptr;
+	}
+}
+
+void PLAYER_Session::set_udp_token(const unsigned_int64 value)
+{
+	// 새 token 은 새 주소, seq 부터 받는다.
+	udpToken.store(value, std::memory_order_release);
+	udpRecvSeq = 0;
+	udpSendSeq = 0;
+	udpBound = false;
+	memset(&udpAddr, 0, sizeof(udpAddr));
+}
+
+void PLAYER_Session::set_udp_addr(const struct sockaddr_in & addr)
+{
+	udpAddr = addr;
+	udpBound = true;
+}
+
+void PLAYER_Session::set_readPaused(const bool value)
+{
+	if (value && !readPaused) {
+		pauseCnt++;
+	}
+	readPaused.store(value, std::memory_order_relaxed);
 }
 
 void PLAYER_Session::update_error_cnt()
@@ -19,17 +95,121 @@ void PLAYER_Session::update_error_cnt()
 
 bool PLAYER_Session::sendReady(char * pMsg, int size)
 {
-	m_sendBuffer.setWriteBuffer(pMsg, size);
+	// 호출한 쪽의 Buffer 는 바로 재사용 되므로 복사해서 보관한다.
+	SEND_Frame frame;
+	frame.pMsg = new char[size];
+	frame.size = size;
+	frame.pShared = nullptr;
+	memcpy(frame.pMsg, pMsg, size);
+	sendQueue.push_back(frame);
+	sendPendingSize += size;
 	return true;
 }
 
-bool PLAYER_Session::sendIo()
+bool PLAYER_Session::sendReadyShared(Shared_Buffer * pShared)
 {
-	return write(m_socketSession, m_sendBuffer.getReadBuffer(), m_sendBuffer.getReadAbleSize());
+	SEND_Frame frame;
+	frame.pMsg = pShared->get_data();
+	frame.size = pShared->get_size();
+	frame.pShared = pShared;
+	sendQueue.push_back(frame);
+	sendPendingSize += frame.size;
+	return true;
 }
 
-bool PLAYER_Session::sendFinish(int size)
+void PLAYER_Session::free_frame(SEND_Frame & frame)
 {
-	m_sendBuffer.moveReadPos(size);
-	return true;
+	if (frame.pShared != nullptr) {
+		frame.pShared->release();
+	}
+	else {
+		delete[] frame.pMsg;
+	}
+}
+
+SendResult PLAYER_Session::sendIo(int& callCnt)
+{
+	struct iovec iov[MAX_SEND_IOV];
+	struct msghdr msg;
+	while (!sendQueue.empty()) {
+		// 쌓여 있는 Packet 들을 iovec 으로 묶어서 한번에 보낸다.
+		int iovCnt = 0;
+		for (auto iter = sendQueue.begin(); iter != sendQueue.end() && iovCnt < MAX_SEND_IOV; ++iter, ++iovCnt) {
+			int offset = (iovCnt == 0) ? sendOffset : 0;
+			iov[iovCnt].iov_base = iter->pMsg + offset;
+			iov[iovCnt].iov_len = iter->size - offset;
+		}
+		memset(&msg, 0, sizeof msg);
+		msg.msg_iov = iov;
+		msg.msg_iovlen = iovCnt;
+
+		// MSG_NOSIGNAL : 끊어진 소켓에 보낼때 SIGPIPE 로 서버가 종료되지 않도록 한다.
+		int ioSize = sendmsg(m_socketSession, &msg, MSG_NOSIGNAL);
+		callCnt++;
+		if (ioSize < 0) {
+			if (errno == EAGAIN || errno == EWOULDBLOCK) {
+				return SEND_PENDING;
+			}
+			else if (errno == EINTR) {
+				continue;
+			}
+			spdlog::error("[sendIo] send Error : {} || [unique_no:{}]", errno, get_unique_no());
+			return SEND_ERROR;
+		}
+		sendFinish(ioSize);
+	}
+	return SEND_COMPLETE;
+}
+
+void PLAYER_Session::sendFinish(int size)
+{
+	sendPendingSize -= size;
+	while (size > 0 && !sendQueue.empty()) {
+		SEND_Frame& frame = sendQueue.front();
+		int remain = frame.size - sendOffset;
+		if (size < remain) {
+			// 일부만 전송 되었다.
+			sendOffset += size;
+			return;
+		}
+		size -= remain;
+		sendOffset = 0;
+		free_frame(frame);
+		sendQueue.pop_front();
+	}
+}
+
+int PLAYER_Session::copy_sendQueue(std::string& out)
+{
+	// 이미 보낸 앞 부분 (sendOffset) 은 제외 한다.
+	out.clear();
+	out.reserve(sendPendingSize);
+	int offset = sendOffset;
+	for (auto& frame : sendQueue) {
+		out.append(frame.pMsg + offset, frame.size - offset);
+		offset = 0;
+	}
+	return (int)out.size();
+}
+
+void PLAYER_Session::clear_sendQueue()
+{
+	for (auto& frame : sendQueue) {
+		free_frame(frame);
+	}
+	sendQueue.clear();
+	sendOffset = 0;
+	sendPendingSize = 0;
+	sendArmed = false;
+	sendDirty = false;
+}
+
+Shared_Buffer * Shared_Buffer::create(const char * pMsg, const int size)
+{
+	Shared_Buffer *pShared = new Shared_Buffer;
+	pShared->refCnt.store(1, std::memory_order_relaxed);
+	pShared->size = size;
+	pShared->pData = new char[size];
+	memcpy(pShared->pData, pMsg, size);
+	return pShared;
 }
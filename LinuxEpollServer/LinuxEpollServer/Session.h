@@ -3,41 +3,126 @@
 
 #include "Main.h"
 #include "ReadBuffer.h"
+#include <deque>
+#include <sys/uio.h>
+#include <netinet/in.h>
 
-class PLAYER_Session {
+#define MAX_SEND_IOV 64		// sendmsg 한번에 묶어 보내는 Packet 수
+
+// sendIo 결과
+enum SendResult {
+	SEND_COMPLETE,		// sendQueue 를 모두 보냈다.
+	SEND_PENDING,		// EAGAIN, EPOLLOUT 을 기다린다.
+	SEND_ERROR			// 소켓 오류
+};
+
+// 여러 세션에 같은 내용을 보내는 Packet (Broadcast)
+// 한번만 복사하고 sendQueue 에는 참조로 넣는다. 마지막 세션이 전송을 마치면 해제 된다.
+class Shared_Buffer {
 public:
-	PLAYER_Session() {
-		m_readBuffer.init(MAX_SOCKBUF);
-		m_sendBuffer.init(MAX_SOCKBUF);
-		m_socketSession = INVALID_SOCKET;
-		unique_no = 0;
-		error_cnt = 0;
-		remainSize = 0;
+	static Shared_Buffer * create(const char* pMsg, const int size);	// refCnt 1 로 생성
+	void add_ref() { refCnt.fetch_add(1, std::memory_order_relaxed); }
+	void release() {
+		if (refCnt.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			delete this;
+		}
 	}
+	char* get_data() { return pData; }
+	int get_size() { return size; }
+
+private:
+	Shared_Buffer() {}
+	~Shared_Buffer() { delete[] pData; }
+	std::atomic<int> refCnt;
+	int size;
+	char* pData;
+};
+
+// 전송 대기중인 Packet
+struct SEND_Frame {
+	char* pMsg;
+	int size;
+	Shared_Buffer* pShared;		// Broadcast 공유 Buffer (nullptr : pMsg 단독 소유)
+};
+
+class PLAYER_Session {
+public:
+	PLAYER_Session();
+	~PLAYER_Session() { clear_sendQueue(); end_chain(); }
 	// get
 	int& get_sock() { return m_socketSession; }
 	ReadBuffer& read_buffer() { return m_readBuffer; }
-	ReadBuffer& send_buffer() { return m_sendBuffer; }
-	unsigned_int64 get_unique_no() { return unique_no; }
+	Chain_Buffer* get_chain() { return pChain; }
+	std::mutex& send_mutex() { return mSendLock; }
+	int get_sendPendingSize() { return sendPendingSize; }
+	bool get_sendArmed() { return sendArmed; }
+	bool get_sendDirty() { return sendDirty; }
+	unsigned_int64 get_unique_no() { return unique_no.load(std::memory_order_relaxed); }
 	int get_error_cnt() { return error_cnt; }
-	int get_remainSize() { return remainSize; }
+	int get_reactor_no() { return reactor_no; }
+	int get_slot_no() { return slot_no; }
+	session_handle get_handle() { return handle; }
+	unsigned_int64 get_last_active() { return lastActiveTick.load(std::memory_order_relaxed); }
+	timer_id get_idle_timer() { return idleTimer.load(std::memory_order_relaxed); }
+	int get_queued_frames() { return queuedFrames.load(std::memory_order_relaxed); }
+	bool get_readPaused() { return readPaused.load(std::memory_order_relaxed); }
+	unsigned_int64 get_pause_cnt() { return pauseCnt; }
+	unsigned_int64 get_udp_token() { return udpToken.load(std::memory_order_acquire); }
+	unsigned int get_udp_recv_seq() { return udpRecvSeq; }
+	bool get_udpBound() { return udpBound; }
+	const struct sockaddr_in& get_udp_addr() { return udpAddr; }
 
 	// set
 	void set_unique_no(const unsigned_int64 id);
 	void set_init_session();
 	void update_error_cnt();
-	void set_remainSize(const int value){ remainSize = value;}
-	void incr_remainSize(const int value) { remainSize += value; }
-	bool sendReady(char* pMsg, int size);
-	bool sendIo();
-	bool sendFinish(int size);
+	void set_reactor_no(const int value) { reactor_no = value; }
+	void set_slot_no(const int value) { slot_no = value; }
+	void set_handle(const session_handle value) { handle = value; }
+	void set_last_active(const unsigned_int64 tick) { lastActiveTick.store(tick, std::memory_order_relaxed); }
+	void set_idle_timer(const timer_id value) { idleTimer.store(value, std::memory_order_relaxed); }
+	void set_sendArmed(const bool value) { sendArmed = value; }
+	void set_sendDirty(const bool value) { sendDirty = value; }
+	void add_queued_frames(const int cnt) { queuedFrames.fetch_add(cnt, std::memory_order_relaxed); }
+	Chain_Buffer* begin_chain(const int frameSize);		// MAX_SOCKBUF 보다 큰 Packet 받기 시작 (I/O Thread)
+	void end_chain();									// block 반납
+	void set_udp_token(const unsigned_int64 value);						// 로그인 시 발급, UDP 연결 초기화 (send_mutex 필요)
+	void set_udp_recv_seq(const unsigned int value) { udpRecvSeq = value; }	// send_mutex 필요
+	void set_udp_addr(const struct sockaddr_in& addr);					// 마지막 UDP 주소 (send_mutex 필요)
+	unsigned int next_udp_send_seq() { return ++udpSendSeq; }			// send_mutex 필요
+	void set_readPaused(const bool value);			// send_mutex 필요
+	bool sendReady(char* pMsg, int size);			// sendQueue 에 추가
+	bool sendReadyShared(Shared_Buffer* pShared);	// 공유 Buffer 를 복사 없이 sendQueue 에 추가 (참조 1개를 넘겨 받는다)
+	SendResult sendIo(int& callCnt);				// EAGAIN 까지 sendmsg 로 묶어서 전송 (send_mutex 필요)
+	void sendFinish(int size);						// 전송된 만큼 sendQueue 에서 제거
+	void clear_sendQueue();							// send_mutex 필요 (소멸자 제외)
+	int copy_sendQueue(std::string& out);			// 보내지 못한 데이터 복사 (send_mutex 필요)
 
 private:
 	int			m_socketSession;			// Cliet와 연결되는 소켓
 	ReadBuffer		m_readBuffer;			// readBuffet
-	ReadBuffer		m_sendBuffer;			// sendBuffet
-	unsigned_int64 unique_no;				// 고유 아이디
+	Chain_Buffer*	pChain;					// 받는 중인 큰 Packet (nullptr : 없음)
+	std::atomic<unsigned_int64> unique_no;	// 고유 아이디 (변경은 send_mutex 안에서, I/O Thread 는 lock 없이 읽는다)
 	int error_cnt;							// 패킷 오류 Count
-	int remainSize;							// Auth Login을 위하여
+	int reactor_no;							// 소속 Reactor (-1 : 단일 EventThread)
+	int slot_no;							// Session_Pool 위치
+	session_handle handle;					// Logic_API 에서 사용하는 핸들 (slot + generation)
+	std::atomic<unsigned_int64> lastActiveTick;	// 마지막 수신 시간 (timer tick)
+	std::atomic<timer_id> idleTimer;		// T_IdleCheck 타이머 (Timer Thread 와 같이 사용)
+	std::mutex mSendLock;					// API Thread 와 Worker 가 같이 사용
+	std::deque<SEND_Frame> sendQueue;		// 전송 대기 Packet
+	int sendOffset;							// sendQueue.front() 에서 이미 보낸 크기
+	int sendPendingSize;					// 전송 대기 전체 크기
+	bool sendArmed;							// EPOLLOUT 등록 여부
+	bool sendDirty;							// FlushSendAll 대기 목록 등록 여부
+	void free_frame(SEND_Frame& frame);		// 단독 소유는 delete[], 공유 Buffer 는 release
+	std::atomic<int> queuedFrames;			// Logic_API 에서 처리 대기중인 Packet 수
+	std::atomic<bool> readPaused;			// 수신 중단 여부 (변경은 send_mutex 안에서)
+	unsigned_int64 pauseCnt;				// 수신 중단 횟수 (누적)
+	std::atomic<unsigned_int64> udpToken;	// UDP datagram 인증 값 (0 : 발급 전)
+	unsigned int udpRecvSeq;				// 마지막으로 받은 UDP seq (send_mutex 필요)
+	unsigned int udpSendSeq;				// 마지막으로 보낸 UDP seq
+	bool udpBound;							// UDP 주소를 받았는가 (이후 이동은 UDP 로 보낸다, send_mutex 필요)
+	struct sockaddr_in udpAddr;				// 클라이언트 UDP 주소 (send_mutex 필요)
 };
 #endif
\ No newline at end of file
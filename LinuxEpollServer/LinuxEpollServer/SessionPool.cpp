@@ -0,0 +1,142 @@
+﻿#include "SessionPool.h"
+
+Session_Pool::Session_Pool()
+{
+	maxSession = 0;
+	fdTableSize = 0;
+	sessions = nullptr;
+	players = nullptr;
+	generations = nullptr;
+	fdTable = nullptr;
+}
+
+Session_Pool::~Session_Pool()
+{
+	delete[] sessions;
+	delete[] players;
+	delete[] generations;
+	delete[] fdTable;
+}
+
+bool Session_Pool::init_pool(const int maxSession)
+{
+	if (maxSession <= 0) {
+		spdlog::error("[SessionPool] MAX_PLAYER({}) is invalid", maxSession);
+		return false;
+	}
+
+	// 프로세스가 열 수 있는 fd 수 만큼 조회 테이블을 만든다.
+	struct rlimit limit;
+	if (getrlimit(RLIMIT_NOFILE, &limit) < 0 || limit.rlim_cur == RLIM_INFINITY || limit.rlim_cur > MAX_FD_TABLE) {
+		fdTableSize = MAX_FD_TABLE;
+	}
+	else {
+		fdTableSize = (int)limit.rlim_cur;
+	}
+	fdTable = new std::atomic<PLAYER_Session *>[fdTableSize];
+	for (int i = 0; i < fdTableSize; i++) {
+		fdTable[i].store(nullptr, std::memory_order_relaxed);
+	}
+
+	// 세션 (ReadBuffer 포함) 은 시작할 때 한번만 만든다.
+	this->maxSession = maxSession;
+	sessions = new PLAYER_Session[maxSession];
+	players = new PLAYER[maxSession];
+	generations = new std::atomic<unsigned int>[maxSession];
+	freeSlot.reserve(maxSession);
+	for (int i = maxSession - 1; i >= 0; i--) {
+		sessions[i].set_slot_no(i);
+		generations[i].store(0, std::memory_order_relaxed);
+		freeSlot.emplace_back(i);
+	}
+	spdlog::info("[SessionPool] sessions : {}, fd table : {}", maxSession, fdTableSize);
+	return true;
+}
+
+PLAYER_Session * Session_Pool::alloc(const int sock)
+{
+	if (freeSlot.empty()) {
+		return nullptr;
+	}
+	if (sock < 0 || sock >= fdTableSize) {
+		spdlog::error("[SessionPool] sock({}) >= fd table({})", sock, fdTableSize);
+		return nullptr;
+	}
+
+	int slot = freeSlot.back();
+	freeSlot.pop_back();
+
+	// 0 은 INVALID_SESSION_HANDLE 이므로 건너뛴다.
+	unsigned int generation = generations[slot].load(std::memory_order_relaxed) + 1;
+	if (generation == 0) generation = 1;
+
+	PLAYER_Session * pPlayerSession = &sessions[slot];
+	pPlayerSession->set_init_session();
+	{
+		// 이전 핸들로 보내는 Thread 는 send_mutex 안에서 핸들을 다시 비교한다.
+		std::lock_guard<std::mutex> guard(pPlayerSession->send_mutex());
+		pPlayerSession->get_sock() = sock;
+		pPlayerSession->set_handle(MAKE_SESSION_HANDLE(generation, slot));
+		generations[slot].store(generation, std::memory_order_release);
+	}
+	players[slot].set_init_player();
+	players[slot].set_sock(sock);
+	fdTable[sock].store(pPlayerSession, std::memory_order_release);
+	return pPlayerSession;
+}
+
+bool Session_Pool::release(const int sock)
+{
+	PLAYER_Session * pPlayerSession = find(sock);
+	if (pPlayerSession == nullptr) {
+		return false;
+	}
+	// generation 을 올려서 남아 있는 핸들을 바로 무효화 한다.
+	int slot = pPlayerSession->get_slot_no();
+	{
+		std::lock_guard<std::mutex> guard(pPlayerSession->send_mutex());
+		generations[slot].fetch_add(1, std::memory_order_release);
+		pPlayerSession->set_handle(INVALID_SESSION_HANDLE);
+	}
+	fdTable[sock].store(nullptr, std::memory_order_release);
+	freeSlot.emplace_back(slot);
+	return true;
+}
+
+PLAYER * Session_Pool::find_player(const int sock)
+{
+	PLAYER_Session * pPlayerSession = find(sock);
+	if (pPlayerSession == nullptr) {
+		return nullptr;
+	}
+	return &players[pPlayerSession->get_slot_no()];
+}
+
+PLAYER_Session * Session_Pool::find_handle(const session_handle handle)
+{
+	int slot = SESSION_HANDLE_SLOT(handle);
+	if (handle == INVALID_SESSION_HANDLE || slot < 0 || slot >= maxSession) {
+		return nullptr;
+	}
+	if (generations[slot].load(std::memory_order_acquire) != SESSION_HANDLE_GEN(handle)) {
+		return nullptr;
+	}
+	return &sessions[slot];
+}
+
+PLAYER * Session_Pool::find_player_handle(const session_handle handle)
+{
+	if (find_handle(handle) == nullptr) {
+		return nullptr;
+	}
+	return &players[SESSION_HANDLE_SLOT(handle)];
+}
+
+PLAYER_Session * Session_Pool::find_slot(const int slot)
+{
+	if (slot < 0 || slot >= maxSession) return nullptr;
+	// 사용중인 slot 만 fd 테이블에 연결되어 있다.
+	PLAYER_Session * pSession = &sessions[slot];
+	if (find(pSession->get_sock()) != pSession) return nullptr;
+	return pSession;
+}
@@ -0,0 +1,47 @@
+﻿#ifndef __SESSION_POOL_H__
+#define __SESSION_POOL_H__
+
+#include "Main.h"
+
+#include <atomic>
+#include <sys/resource.h>
+
+class PLAYER_Session;
+class PLAYER;
+
+#define MAX_FD_TABLE (1 << 20)	// fd 조회 테이블 최대 크기 (RLIMIT_NOFILE 이 무제한 일 때)
+
+// MAX_PLAYER 만큼 세션 / 플레이어를 미리 만들어 두고 재사용 한다.
+// fd 를 index 로 하는 배열에서 바로 세션을 찾는다. (접속 / 종료시 heap 할당 없음)
+// Logic_API 는 slot + generation 핸들로 찾으며, 종료된 세션의 핸들은 generation 비교로 거절 된다.
+class Session_Pool {
+public:
+	Session_Pool();
+	~Session_Pool();
+	bool init_pool(const int maxSession);								// 세션, fd 테이블 생성
+	PLAYER_Session * alloc(const int sock);								// 빈 slot 을 fd 에 연결 (mSessionLock 필요)
+	bool release(const int sock);										// slot 반납 (mSessionLock 필요)
+
+	// get
+	PLAYER_Session * find(const int sock) {
+		if (sock < 0 || sock >= fdTableSize) return nullptr;
+		return fdTable[sock].load(std::memory_order_acquire);
+	}
+	PLAYER * find_player(const int sock);
+	PLAYER_Session * find_handle(const session_handle handle);			// generation 이 다르면 nullptr
+	PLAYER * find_player_handle(const session_handle handle);
+	PLAYER_Session * find_slot(const int slot);							// 사용중인 slot 만 (종료 처리용)
+	int get_use_cnt() { return maxSession - (int)freeSlot.size(); }
+	int get_max_cnt() { return maxSession; }
+
+private:
+	int maxSession;
+	int fdTableSize;
+	PLAYER_Session * sessions;											// slot 별 세션
+	PLAYER * players;													// slot 별 플레이어
+	std::vector<int> freeSlot;											// 빈 slot (stack)
+	std::atomic<unsigned int> * generations;							// slot 별 현재 generation
+	std::atomic<PLAYER_Session *> * fdTable;							// fd -> 세션
+};
+
+#endif
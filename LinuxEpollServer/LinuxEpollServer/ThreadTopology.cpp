@@ -0,0 +1,145 @@
+﻿#include "ThreadTopology.h"
+
+#include <fstream>
+#include <linux/mempolicy.h>
+
+Thread_Topology::Thread_Topology()
+{
+	memPolicySet = false;
+}
+
+void Thread_Topology::init()
+{
+	int numaNode = CS.get_numa_node();
+	if (numaNode >= 0) {
+		// node 의 CPU 목록 (libnuma 없이 sysfs 에서 읽는다)
+		std::ifstream cpuListFile("/sys/devices/system/node/node" + std::to_string(numaNode) + "/cpulist");
+		std::string cpuList;
+		if (cpuListFile && std::getline(cpuListFile, cpuList)) {
+			ConfigSetting::parse_cpu_list(cpuList, nodeCpus);
+		}
+		else {
+			spdlog::error("[Topology] NUMA_NODE ({}) is not found..!", numaNode);
+		}
+
+		// 이후 만드는 Thread 는 메모리 정책을 물려 받으므로 Thread 생성 전에 설정한다.
+		unsigned long nodeMask = 0;
+		if (!nodeCpus.empty() && numaNode < (int)(sizeof(nodeMask) * 8)) {
+			nodeMask = 1UL << numaNode;
+			if (syscall(SYS_set_mempolicy, MPOL_PREFERRED, &nodeMask, sizeof(nodeMask) * 8) == 0) {
+				memPolicySet = true;
+			}
+			else {
+				spdlog::error("[Topology] set_mempolicy({}) Function failure : {}", numaNode, strerror(errno));
+			}
+		}
+
+		// 역할 CPU 가 node 밖에 있으면 원격 메모리를 사용하게 된다.
+		for (int role = 0; role < MAX_THREAD_ROLE; role++) {
+			for (int cpu : CS.get_thread_cpu((THREAD_ROLE)role)) {
+				if (!nodeCpus.empty() && std::find(nodeCpus.begin(), nodeCpus.end(), cpu) == nodeCpus.end()) {
+					spdlog::warn("[Topology] {} CPU {} is not in NUMA_NODE {}", get_role_name((THREAD_ROLE)role), cpu, numaNode);
+				}
+			}
+		}
+	}
+
+	spdlog::info("[Topology] IO_ENGINE : {}, REACTOR_CNT : {}, WORKER_CNT : {}, LOGIC_CNT : {}, NUMA_NODE : {} (cpu {}, mempolicy {})",
+		CS.get_io_engine() == IO_ENGINE_URING ? "uring" : "epoll", CS.get_reactor_cnt(), CS.get_worker_cnt(), CS.get_logic_cnt(),
+		numaNode, nodeCpus.size(), memPolicySet ? "preferred" : "default");
+
+	// Reactor, Logic_API 대기 방식 (spin, busy 는 대기 중에도 CPU 를 사용하므로 고정 CPU 와 같이 쓴다)
+	const char* waitName[] = { "block", "spin", "busy" };
+	spdlog::info("[Topology] WAIT_STRATEGY : {} (SPIN_USEC : {}, BUSY_POLL_USEC : {})",
+		waitName[CS.get_wait_strategy()], CS.get_spin_usec(), CS.get_busy_poll_usec());
+	if (CS.get_wait_strategy() != WAIT_BLOCK && CS.get_thread_cpu(THREAD_LOGIC).empty() && CS.get_thread_cpu(THREAD_REACTOR).empty()) {
+		spdlog::warn("[Topology] WAIT_STRATEGY {} without REACTOR_CPU / LOGIC_CPU", waitName[CS.get_wait_strategy()]);
+	}
+}
+
+void Thread_Topology::bind_thread(const THREAD_ROLE role, const int index)
+{
+	// top -H, perf 에서 역할을 구분할 수 있게 이름을 붙인다. (15 글자 까지)
+	char name[16];
+	snprintf(name, sizeof name, "%s-%d", get_role_name(role), index);
+	pthread_setname_np(pthread_self(), name);
+
+	cpu_set_t cpuSet;
+	CPU_ZERO(&cpuSet);
+	const std::vector<int>& roleCpus = CS.get_thread_cpu(role);
+	if (!roleCpus.empty()) {
+		CPU_SET(roleCpus[index % roleCpus.size()], &cpuSet);
+	}
+	else {
+		for (int cpu : nodeCpus) {
+			CPU_SET(cpu, &cpuSet);
+		}
+	}
+
+	bool pinned = false;
+	if (CPU_COUNT(&cpuSet) > 0) {
+		int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+		if (ret == 0) {
+			pinned = true;
+		}
+		else {
+			spdlog::error("[Topology] {} pthread_setaffinity_np Function failure : {}", name, strerror(ret));
+		}
+	}
+
+	// 실제 적용된 affinity 를 기록한다.
+	THREAD_Info info;
+	info.role = role;
+	info.index = index;
+	info.tid = (pid_t)syscall(SYS_gettid);
+	info.pinned = pinned;
+	CPU_ZERO(&cpuSet);
+	if (pthread_getaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0) {
+		info.cpus = format_cpu_list(cpuSet);
+	}
+	spdlog::info("[Topology] {} tid : {}, cpu : {}{}", name, info.tid, info.cpus, pinned ? "" : " (not pinned)");
+
+	std::lock_guard<std::mutex> guard(mLock);
+	threads.emplace_back(info);
+}
+
+void Thread_Topology::logTopology()
+{
+	std::lock_guard<std::mutex> guard(mLock);
+	std::vector<THREAD_Info> sorted = threads;
+	std::sort(sorted.begin(), sorted.end(), [](const THREAD_Info& a, const THREAD_Info& b) {
+		return a.role != b.role ? a.role < b.role : a.index < b.index;
+	});
+	spdlog::info("[Topology] threads : {}, NUMA_NODE : {}", sorted.size(), CS.get_numa_node());
+	for (auto& info : sorted) {
+		spdlog::info("[Topology] {:<8} {:>2} tid : {:>7}, cpu : {}{}", get_role_name(info.role), info.index, info.tid, info.cpus, info.pinned ? "" : " (not pinned)");
+	}
+}
+
+const char * Thread_Topology::get_role_name(const THREAD_ROLE role)
+{
+	switch (role) {
+	case THREAD_EVENT: return "event";
+	case THREAD_WORKER: return "worker";
+	case THREAD_REACTOR: return "reactor";
+	case THREAD_LOGIC: return "logic";
+	case THREAD_UDP: return "udp";
+	default: return "unknown";
+	}
+}
+
+std::string Thread_Topology::format_cpu_list(const cpu_set_t & set)
+{
+	// 연속된 CPU 는 "0-3" 으로 묶는다.
+	std::string result;
+	for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+		if (!CPU_ISSET(cpu, &set)) continue;
+		int last = cpu;
+		while (last + 1 < CPU_SETSIZE && CPU_ISSET(last + 1, &set)) last++;
+		if (!result.empty()) result += ",";
+		result += std::to_string(cpu);
+		if (last > cpu) result += "-" + std::to_string(last);
+		cpu = last;
+	}
+	return result;
+}
@@ -0,0 +1,37 @@
+﻿#ifndef __THREAD_TOPOLOGY_H__
+#define __THREAD_TOPOLOGY_H__
+
+#include "Main.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+
+// [Threads] 설정으로 Thread 를 CPU / NUMA node 에 고정한다.
+// 역할의 CPU 목록이 있으면 Thread 마다 하나씩 돌아가며 고정하고 (index % 목록 수),
+// 없으면 NUMA_NODE 의 CPU 안에서만 옮겨 다니게 한다. (둘 다 없으면 scheduler 에 맡긴다)
+// 각 Thread 는 시작할 때 bind_thread 를 호출하고, 실제 적용된 affinity 를 기록해서 출력한다.
+class Thread_Topology {
+public:
+	Thread_Topology();
+	void init();																// NUMA 메모리 정책, 설정 출력 (Thread 생성 전 main 에서)
+	void bind_thread(const THREAD_ROLE role, const int index);					// 현재 Thread 이름 설정, CPU 고정
+	void logTopology();															// Thread 별 tid, CPU 출력
+	static const char* get_role_name(const THREAD_ROLE role);
+
+private:
+	struct THREAD_Info {
+		THREAD_ROLE role;
+		int index;
+		pid_t tid;
+		bool pinned;															// 설정으로 고정 되었는가
+		std::string cpus;														// 실제 affinity ("0-3,8")
+	};
+	std::vector<THREAD_Info> threads;
+	std::vector<int> nodeCpus;													// NUMA_NODE 의 CPU (sysfs)
+	bool memPolicySet;															// NUMA_NODE 메모리 우선 할당 적용 여부
+	std::mutex mLock;
+	static std::string format_cpu_list(const cpu_set_t& set);
+};
+
+#endif
@@ -0,0 +1,287 @@
+﻿#include "Timer.h"
+
+Timer_Wheel::Timer_Wheel()
+{
+	for (int i = 0; i < WHEEL_SLOT_CNT; i++) {
+		wheel[i] = -1;
+	}
+	currentTick = 0;
+	timerCnt = 0;
+}
+
+timer_id Timer_Wheel::schedule(const unsigned_int64 delayTick, const Timer_Event& t)
+{
+	int idx;
+	if (freeNode.empty()) {
+		idx = (int)nodes.size();
+		nodes.emplace_back();
+		nodes[idx].generation = 0;
+	}
+	else {
+		idx = freeNode.back();
+		freeNode.pop_back();
+	}
+
+	// 0 은 INVALID_TIMER_ID 이므로 건너뛴다.
+	Timer_Node& node = nodes[idx];
+	if (++node.generation == 0) node.generation = 1;
+	node.expire = currentTick + (delayTick > WHEEL_MAX_TICK ? WHEEL_MAX_TICK : delayTick);
+	node.event = t;
+	addNode(idx);
+	timerCnt++;
+	return ((timer_id)node.generation << 32) | (unsigned int)idx;
+}
+
+bool Timer_Wheel::cancel(const timer_id id)
+{
+	int idx = (int)(id & 0xffffffff);
+	if (id == INVALID_TIMER_ID || idx < 0 || idx >= (int)nodes.size()) {
+		return false;
+	}
+	Timer_Node& node = nodes[idx];
+	if (node.slot < 0 || node.generation != (unsigned int)(id >> 32)) {
+		// 이미 실행 되었거나 취소 되었다.
+		return false;
+	}
+	unlink(idx);
+	freeNode.emplace_back(idx);
+	timerCnt--;
+	return true;
+}
+
+int Timer_Wheel::advance(const unsigned_int64 nowTick, std::vector<Timer_Event>& expired)
+{
+	int fired = 0;
+	while (currentTick <= nowTick) {
+		int index = (int)(currentTick & (WHEEL_ROOT_SIZE - 1));
+		// 0 단계가 한바퀴 돌면 윗 단계 칸을 내려준다.
+		if (index == 0) {
+			for (int level = 0; level < WHEEL_LEVEL_CNT; level++) {
+				int levelIndex = (int)((currentTick >> (WHEEL_ROOT_BITS + level * WHEEL_LEVEL_BITS)) & (WHEEL_LEVEL_SIZE - 1));
+				cascade(level, levelIndex);
+				if (levelIndex != 0) break;
+			}
+		}
+
+		while (wheel[index] >= 0) {
+			int idx = wheel[index];
+			unlink(idx);
+			expired.emplace_back(nodes[idx].event);
+			freeNode.emplace_back(idx);
+			timerCnt--;
+			fired++;
+		}
+		currentTick++;
+	}
+	return fired;
+}
+
+void Timer_Wheel::addNode(const int idx)
+{
+	Timer_Node& node = nodes[idx];
+	unsigned_int64 expire = node.expire;
+	unsigned_int64 diff = expire - currentTick;
+	int slot;
+	if (expire < currentTick) {
+		// 이미 지났다 -> 다음 tick 에 실행
+		slot = (int)(currentTick & (WHEEL_ROOT_SIZE - 1));
+	}
+	else if (diff < WHEEL_ROOT_SIZE) {
+		slot = (int)(expire & (WHEEL_ROOT_SIZE - 1));
+	}
+	else {
+		int level = 0;
+		while (level < WHEEL_LEVEL_CNT - 1 && diff >= (1ULL << (WHEEL_ROOT_BITS + (level + 1) * WHEEL_LEVEL_BITS))) {
+			level++;
+		}
+		int levelIndex = (int)((expire >> (WHEEL_ROOT_BITS + level * WHEEL_LEVEL_BITS)) & (WHEEL_LEVEL_SIZE - 1));
+		slot = WHEEL_ROOT_SIZE + level * WHEEL_LEVEL_SIZE + levelIndex;
+	}
+
+	// 칸의 맨 앞에 넣는다.
+	node.slot = slot;
+	node.prev = -1;
+	node.next = wheel[slot];
+	if (node.next >= 0) {
+		nodes[node.next].prev = idx;
+	}
+	wheel[slot] = idx;
+}
+
+void Timer_Wheel::unlink(const int idx)
+{
+	Timer_Node& node = nodes[idx];
+	if (node.prev >= 0) {
+		nodes[node.prev].next = node.next;
+	}
+	else {
+		wheel[node.slot] = node.next;
+	}
+	if (node.next >= 0) {
+		nodes[node.next].prev = node.prev;
+	}
+	node.slot = -1;
+	node.prev = -1;
+	node.next = -1;
+}
+
+void Timer_Wheel::cascade(const int level, const int index)
+{
+	int slot = WHEEL_ROOT_SIZE + level * WHEEL_LEVEL_SIZE + index;
+	int idx = wheel[slot];
+	wheel[slot] = -1;
+	while (idx >= 0) {
+		int next = nodes[idx].next;
+		addNode(idx);
+		idx = next;
+	}
+}
+
+SERVER_Timer::SERVER_Timer()
+{
+	timerFd = -1;
+	fireCnt = 0;
+	nowTick = 0;
+	startTime = std::chrono::steady_clock::now();
+}
+
+SERVER_Timer::~SERVER_Timer()
+{
+	stop();
+}
+
+bool SERVER_Timer::start()
+{
+	if ((timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)) < 0) {
+		spdlog::error("timerfd_create() Function failure : {}", strerror(errno));
+		return false;
+	}
+
+	struct itimerspec spec;
+	memset(&spec, 0, sizeof spec);
+	spec.it_interval.tv_nsec = TIMER_TICK_MS * 1000000L;
+	spec.it_value.tv_nsec = TIMER_TICK_MS * 1000000L;
+	if (timerfd_settime(timerFd, 0, &spec, NULL) < 0) {
+		spdlog::error("timerfd_settime() Function failure : {}", strerror(errno));
+		return false;
+	}
+	startTime = std::chrono::steady_clock::now();
+	spdlog::info("Server Timer Start..! (tick : {}ms)", TIMER_TICK_MS);
+	return true;
+}
+
+bool SERVER_Timer::stop()
+{
+	if (timerFd >= 0) {
+		close(timerFd);
+		timerFd = -1;
+	}
+	return true;
+}
+
+unsigned_int64 SERVER_Timer::get_now_tick()
+{
+	auto elapsed = std::chrono::steady_clock::now() - startTime;
+	return std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() / TIMER_TICK_MS;
+}
+
+timer_id SERVER_Timer::setTimerEvent(const Timer_Event& t, const int delayMs)
+{
+	// 최소 1 tick 뒤에 실행한다.
+	unsigned_int64 delayTick = (delayMs + TIMER_TICK_MS - 1) / TIMER_TICK_MS;
+	if (delayTick == 0) delayTick = 1;
+	std::lock_guard<std::mutex> guard(mLock);
+	return wheel.schedule(delayTick, t);
+}
+
+bool SERVER_Timer::cancelTimerEvent(const timer_id id)
+{
+	std::lock_guard<std::mutex> guard(mLock);
+	return wheel.cancel(id);
+}
+
+void SERVER_Timer::OnTick()
+{
+	uint64_t expirations;
+	if (read(timerFd, &expirations, sizeof expirations) < 0) {
+		// EAGAIN (다른 Thread 가 이미 읽었다)
+	}
+
+	unsigned_int64 tick = get_now_tick();
+	nowTick.store(tick, std::memory_order_relaxed);
+	{
+		std::lock_guard<std::mutex> guard(mLock);
+		wheel.advance(tick, expired);
+	}
+
+	// 이벤트 처리는 lock 밖에서 한다. (처리 중에 다시 setTimerEvent 가능)
+	for (auto& t : expired) {
+		epoll_server.TimerProcessing(t);
+	}
+	fireCnt.fetch_add(expired.size(), std::memory_order_relaxed);
+	expired.clear();
+
+	// 타이머 처리 중에 보낸 Packet (ping) 을 전송한다.
+	epoll_server.FlushSendAll();
+}
+
+void SERVER_Timer::logStats()
+{
+	size_t timerCnt;
+	{
+		std::lock_guard<std::mutex> guard(mLock);
+		timerCnt = wheel.get_timer_cnt();
+	}
+	spdlog::info("[Timer] pending : {}, fired : {}", timerCnt, fireCnt.load(std::memory_order_relaxed));
+}
+
+void SERVER_Timer::benchmark(const int timerCnt)
+{
+	// 서버 타이머와 별도의 Wheel 로 측정한다.
+	Timer_Wheel *pWheel = new Timer_Wheel;
+	std::vector<timer_id> ids;
+	std::vector<Timer_Event> fired;
+	ids.reserve(timerCnt);
+	fired.reserve(WHEEL_ROOT_SIZE * 16);
+
+	Timer_Event t;
+	t.handle = INVALID_SESSION_HANDLE;
+	t.event = T_NormalTime;
+
+	// 0 ~ 2 단계에 고르게 퍼지도록 1 ~ 65535 tick 사이로 넣는다.
+	unsigned int seed = 2463534242u;
+	auto begin = std::chrono::steady_clock::now();
+	for (int i = 0; i < timerCnt; i++) {
+		seed ^= seed << 13; seed ^= seed >> 17; seed ^= seed << 5;
+		ids.emplace_back(pWheel->schedule(1 + (seed & 0xffff), t));
+	}
+	auto scheduled = std::chrono::steady_clock::now();
+
+	// 절반을 취소 한다.
+	int cancelCnt = 0;
+	for (int i = 0; i < timerCnt; i += 2) {
+		if (pWheel->cancel(ids[i])) cancelCnt++;
+	}
+	auto canceled = std::chrono::steady_clock::now();
+
+	// 남은 타이머가 모두 실행될 때 까지 돌린다.
+	unsigned_int64 fireCnt = 0;
+	while (pWheel->get_timer_cnt() > 0) {
+		fireCnt += pWheel->advance(pWheel->get_tick() + WHEEL_ROOT_SIZE, fired);
+		fired.clear();
+	}
+	auto finished = std::chrono::steady_clock::now();
+
+	auto rate = [](const int cnt, std::chrono::steady_clock::duration d) {
+		double sec = std::chrono::duration<double>(d).count();
+		return sec > 0 ? cnt / sec / 1000000.0 : 0.0;
+	};
+	spdlog::info("[Timer Benchmark] schedule {} : {:.2f} M/s, cancel {} : {:.2f} M/s, fire {} : {:.2f} M/s ({} ticks)",
+		timerCnt, rate(timerCnt, scheduled - begin),
+		cancelCnt, rate(cancelCnt, canceled - scheduled),
+		fireCnt, rate((int)fireCnt, finished - canceled), pWheel->get_tick());
+	if ((int)fireCnt != timerCnt - cancelCnt) {
+		spdlog::error("[Timer Benchmark] fired({}) != scheduled({}) - canceled({})", fireCnt, timerCnt, cancelCnt);
+	}
+	delete pWheel;
+}
@@ -0,0 +1,83 @@
+﻿#ifndef __TIMER_H__
+#define __TIMER_H__
+
+#include "Main.h"
+
+#include <chrono>
+#include <sys/timerfd.h>
+
+#define TIMER_TICK_MS 10							// timerfd 주기 (Wheel 1칸)
+#define WHEEL_ROOT_BITS 8							// 0 단계 : 256칸 (2.56초)
+#define WHEEL_LEVEL_BITS 6							// 1 ~ 3 단계 : 64칸 씩
+#define WHEEL_LEVEL_CNT 3
+#define WHEEL_ROOT_SIZE (1 << WHEEL_ROOT_BITS)
+#define WHEEL_LEVEL_SIZE (1 << WHEEL_LEVEL_BITS)
+#define WHEEL_SLOT_CNT (WHEEL_ROOT_SIZE + WHEEL_LEVEL_CNT * WHEEL_LEVEL_SIZE)
+#define WHEEL_MAX_TICK ((1ULL << (WHEEL_ROOT_BITS + WHEEL_LEVEL_CNT * WHEEL_LEVEL_BITS)) - 1)	// 약 7.7일
+#define TIMER_BENCH_CNT 1000000						// 콘솔 't' 입력시 benchmark 타이머 수
+
+struct Timer_Event {
+	session_handle handle;							// 대상 세션 (없으면 INVALID_SESSION_HANDLE)
+	TimerType event;								// 어떤 이벤트 인가
+};
+
+// 계층형 Timing Wheel (schedule / cancel O(1))
+// Node 는 배열에 모아 두고 index 로 연결하여 타이머 마다 heap 할당을 하지 않는다.
+// Thread 안전하지 않다. (SERVER_Timer 가 lock 을 잡는다)
+class Timer_Wheel {
+public:
+	Timer_Wheel();
+	timer_id schedule(const unsigned_int64 delayTick, const Timer_Event& t);
+	bool cancel(const timer_id id);
+	int advance(const unsigned_int64 nowTick, std::vector<Timer_Event>& expired);	// nowTick 까지 만료된 이벤트를 꺼낸다.
+	unsigned_int64 get_tick() { return currentTick; }
+	size_t get_timer_cnt() { return timerCnt; }
+
+private:
+	struct Timer_Node {
+		unsigned_int64 expire;						// 만료 tick
+		int prev;
+		int next;
+		int slot;									// 들어 있는 wheel 칸 (-1 : 사용 안함)
+		unsigned int generation;
+		Timer_Event event;
+	};
+	std::vector<Timer_Node> nodes;
+	std::vector<int> freeNode;						// 빈 node (stack)
+	int wheel[WHEEL_SLOT_CNT];						// 칸 별 첫 node (-1 : 비어 있음)
+	unsigned_int64 currentTick;						// 다음에 처리할 tick
+	size_t timerCnt;
+
+	void addNode(const int idx);					// 남은 시간에 맞는 단계의 칸에 넣는다.
+	void unlink(const int idx);
+	void cascade(const int level, const int index);	// 윗 단계 칸을 아래 단계로 내린다.
+};
+
+// timerfd 로 TIMER_TICK_MS 마다 깨어나는 서버 타이머
+// timerfd 는 EventThread (Reactor 0, Uring Engine) 의 epoll 에 같이 등록되어 OnTick 이 호출된다.
+class SERVER_Timer {
+public:
+	SERVER_Timer();
+	~SERVER_Timer();
+	bool start();													// timerfd 생성
+	bool stop();
+	int get_fd() { return timerFd; }
+	unsigned_int64 get_tick() { return nowTick.load(std::memory_order_relaxed); }	// 마지막 OnTick 시점 (syscall 없는 시계)
+	timer_id setTimerEvent(const Timer_Event& t, const int delayMs);	// 다른 Thread 에서 호출 가능
+	bool cancelTimerEvent(const timer_id id);
+	void OnTick();													// 만료된 이벤트를 epoll_server 로 보낸다.
+	void logStats();
+	static void benchmark(const int timerCnt);						// schedule / cancel / fire 처리량 출력
+
+private:
+	int timerFd;
+	std::mutex mLock;
+	Timer_Wheel wheel;
+	std::vector<Timer_Event> expired;								// OnTick 에서만 사용
+	std::chrono::steady_clock::time_point startTime;				// tick 기준 시간
+	std::atomic<unsigned_int64> fireCnt;							// 실행된 타이머 수
+	std::atomic<unsigned_int64> nowTick;							// OnTick 에서 갱신
+	unsigned_int64 get_now_tick();
+};
+
+#endif
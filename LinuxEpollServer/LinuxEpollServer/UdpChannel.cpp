@@ -0,0 +1,336 @@
+﻿#include "UdpChannel.h"
+
+#include <poll.h>
+
+// 주변 세션 이동 전송 (Logic_API shard 별)
+static thread_local UDP_SendBatch sendBatch;
+
+Udp_Channel::Udp_Channel()
+{
+	udpSock = -1;
+	udpPort = 0;
+	wakeFd = -1;
+	threadRun = false;
+	tokenRandom.seed(std::random_device{}());
+	recvDatagramCnt = 0;
+	recvCallCnt = 0;
+	staleDropCnt = 0;
+	invalidDropCnt = 0;
+	pausedDropCnt = 0;
+	sendDatagramCnt = 0;
+	sendCallCnt = 0;
+	sendDropCnt = 0;
+}
+
+Udp_Channel::~Udp_Channel()
+{
+	stop();
+}
+
+bool Udp_Channel::start(const int port)
+{
+	if (port <= 0) {
+		return false;
+	}
+
+	udpSock = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (udpSock < 0) {
+		spdlog::error("[UDP] socket() Function failure : {}", strerror(errno));
+		return false;
+	}
+	// Hot Restart 중에는 두 프로세스가 같은 포트를 사용한다.
+	int option = 1;
+	setsockopt(udpSock, SOL_SOCKET, SO_REUSEADDR, &option, sizeof(option));
+	setsockopt(udpSock, SOL_SOCKET, SO_REUSEPORT, &option, sizeof(option));
+
+	struct sockaddr_in addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(port);
+	addr.sin_addr.s_addr = htonl(INADDR_ANY);
+	if (bind(udpSock, (struct sockaddr *) &addr, sizeof(addr)) < 0) {
+		spdlog::error("[UDP] bind({}) Function failure : {}", port, strerror(errno));
+		close(udpSock);
+		udpSock = -1;
+		return false;
+	}
+	wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (wakeFd < 0) {
+		spdlog::error("[UDP] eventfd() Function failure : {}", strerror(errno));
+		close(udpSock);
+		udpSock = -1;
+		return false;
+	}
+
+	// recvmmsg 는 Buffer 위치를 고정해 두고 msg_len, msg_namelen 만 다시 채운다.
+	for (int i = 0; i < UDP_BATCH; i++) {
+		recvIov[i].iov_base = recvBuf[i];
+		recvIov[i].iov_len = UDP_MAX_DATAGRAM;
+		memset(&recvMsgs[i], 0, sizeof(recvMsgs[i]));
+		recvMsgs[i].msg_hdr.msg_iov = &recvIov[i];
+		recvMsgs[i].msg_hdr.msg_iovlen = 1;
+		recvMsgs[i].msg_hdr.msg_name = &recvAddrs[i];
+		recvMsgs[i].msg_hdr.msg_namelen = sizeof(recvAddrs[i]);
+	}
+
+	udpPort = port;
+	threadRun = true;
+	mRecvThread = std::thread([this]() { RecvThread(); });
+	spdlog::info("[UDP] Movement channel port : {}", port);
+	return true;
+}
+
+void Udp_Channel::stop()
+{
+	threadRun = false;
+	if (wakeFd >= 0) {
+		uint64_t value = 1;
+		if (write(wakeFd, &value, sizeof value) < 0) {
+			// counter overflow
+		}
+	}
+	if (mRecvThread.joinable()) {
+		mRecvThread.join();
+	}
+	if (udpSock >= 0) {
+		close(udpSock);
+		udpSock = -1;
+	}
+	if (wakeFd >= 0) {
+		close(wakeFd);
+		wakeFd = -1;
+	}
+}
+
+unsigned_int64 Udp_Channel::issue_token(const session_handle handle)
+{
+	if (!is_enabled()) {
+		return 0;
+	}
+	auto pPlayerSession = epoll_server.getSessionByHandle(handle);
+	if (pPlayerSession == nullptr) {
+		return 0;
+	}
+	// 0 은 발급 전 값이므로 사용하지 않는다.
+	unsigned_int64 token = 0;
+	{
+		std::lock_guard<std::mutex> tokenGuard(mTokenLock);
+		while (token == 0) {
+			token = tokenRandom();
+		}
+	}
+	std::lock_guard<std::mutex> guard(pPlayerSession->send_mutex());
+	// 그 사이 종료 (재사용) 된 세션에는 발급하지 않는다.
+	if (pPlayerSession->get_handle() != handle) {
+		return 0;
+	}
+	pPlayerSession->set_udp_token(token);
+	return token;
+}
+
+void Udp_Channel::RecvThread()
+{
+	topology.bind_thread(THREAD_UDP, 0);
+	struct pollfd fds[2];
+	fds[0].fd = udpSock;
+	fds[0].events = POLLIN;
+	fds[1].fd = wakeFd;
+	fds[1].events = POLLIN;
+
+	while (threadRun) {
+		fds[0].revents = 0;
+		fds[1].revents = 0;
+		if (poll(fds, 2, -1) < 0) {
+			continue;
+		}
+		if (fds[1].revents & POLLIN) {
+			break;
+		}
+
+		// EAGAIN 까지 UDP_BATCH 개씩 한번에 받는다.
+		while (threadRun) {
+			for (int i = 0; i < UDP_BATCH; i++) {
+				recvMsgs[i].msg_hdr.msg_namelen = sizeof(recvAddrs[i]);
+			}
+			int msgCnt = recvmmsg(udpSock, recvMsgs, UDP_BATCH, MSG_DONTWAIT, NULL);
+			if (msgCnt <= 0) {
+				if (msgCnt < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+					spdlog::error("[UDP] recvmmsg() Function failure : {}", strerror(errno));
+				}
+				break;
+			}
+			recvCallCnt.fetch_add(1, std::memory_order_relaxed);
+			recvDatagramCnt.fetch_add(msgCnt, std::memory_order_relaxed);
+			for (int i = 0; i < msgCnt; i++) {
+				if (recvMsgs[i].msg_hdr.msg_flags & MSG_TRUNC) {
+					invalidDropCnt.fetch_add(1, std::memory_order_relaxed);
+					continue;
+				}
+				OnDatagram(recvBuf[i], (int)recvMsgs[i].msg_len, recvAddrs[i]);
+			}
+			if (msgCnt < UDP_BATCH) {
+				break;
+			}
+		}
+	}
+}
+
+void Udp_Channel::OnDatagram(char * pData, const int size, const sockaddr_in & addr)
+{
+	UDP_HEADER header;
+	if (size < (int)sizeof(header) + PACKET_HEADER_BYTE) {
+		invalidDropCnt.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	memcpy(&header, pData, sizeof(header));
+
+	// 종료 (재사용) 된 세션, 발급 받지 않은 token 은 버린다.
+	auto pPlayerSession = epoll_server.getSessionByHandle(header.handle);
+	if (pPlayerSession == nullptr || header.token == 0 || header.token != pPlayerSession->get_udp_token()) {
+		invalidDropCnt.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	// datagram 하나에 이동 Packet 하나만 허용한다.
+	FRAME_View frame;
+	int readSize = 0;
+	char* pMsg = pData + sizeof(header);
+	int msgSize = size - (int)sizeof(header);
+	if (PacketDecoder::decode(pMsg, msgSize, &frame, 1, readSize) != 1 || readSize != msgSize || frame.type != CLIENT_AUTH_TEST) {
+		invalidDropCnt.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	int sock;
+	unsigned_int64 uniqueNo;
+	{
+		// seq, 주소는 재로그인 (set_udp_token) 시 send_mutex 안에서 초기화 되므로 같은 lock 안에서 비교, 갱신 한다.
+		// 세션 값 읽기, 처리 대기 수 증가도 handle 을 확인한 lock 안에서 한다. (그 사이 종료, 재사용 된 세션에 더하지 않는다)
+		std::lock_guard<std::mutex> guard(pPlayerSession->send_mutex());
+		if (pPlayerSession->get_handle() != header.handle || header.token != pPlayerSession->get_udp_token()) {
+			invalidDropCnt.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		// 마지막 seq 이하는 늦게 도착한 (이미 지나간) 이동 이다. (seq 가 한바퀴 도는 경우를 위해 차이로 비교)
+		unsigned int lastSeq = pPlayerSession->get_udp_recv_seq();
+		if (lastSeq != 0 && (int)(header.seq - lastSeq) <= 0) {
+			staleDropCnt.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		pPlayerSession->set_udp_recv_seq(header.seq);
+
+		// 처음 받았거나 주소가 바뀌면 (NAT) 이후 이동은 이 주소로 보낸다.
+		const struct sockaddr_in& boundAddr = pPlayerSession->get_udp_addr();
+		if (!pPlayerSession->get_udpBound() || boundAddr.sin_addr.s_addr != addr.sin_addr.s_addr || boundAddr.sin_port != addr.sin_port) {
+			pPlayerSession->set_udp_addr(addr);
+		}
+
+		// UDP 는 다시 보내지 않으므로 수신 중단 세션의 이동은 버린다.
+		if (pPlayerSession->get_readPaused()) {
+			pausedDropCnt.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		pPlayerSession->set_last_active(timer.get_tick());
+		pPlayerSession->add_queued_frames(1);
+		sock = pPlayerSession->get_sock();
+		uniqueNo = pPlayerSession->get_unique_no();
+	}
+	api.packet_Add(header.handle, sock, uniqueNo, frame.pMsg, frame.size);
+}
+
+int Udp_Channel::SendMove(const session_handle * handles, const int handleCnt, char * pMsg, int nLen, std::vector<session_handle>& tcpHandles)
+{
+	tcpHandles.clear();
+	if (!is_enabled()) {
+		tcpHandles.assign(handles, handles + handleCnt);
+		return 0;
+	}
+
+	int udpCnt = 0;
+	int msgCnt = 0;
+	for (int i = 0; i < handleCnt; i++) {
+		auto pPlayerSession = epoll_server.getSessionByHandle(handles[i]);
+		if (pPlayerSession == nullptr) {
+			continue;
+		}
+		{
+			std::lock_guard<std::mutex> guard(pPlayerSession->send_mutex());
+			if (pPlayerSession->get_handle() != handles[i]) {
+				continue;
+			}
+			if (!pPlayerSession->get_udpBound()) {
+				// 아직 UDP 를 보내지 않은 세션은 TCP 로 보낸다.
+				tcpHandles.emplace_back(handles[i]);
+				continue;
+			}
+			sendBatch.addrs[msgCnt] = pPlayerSession->get_udp_addr();
+			sendBatch.headers[msgCnt].seq = pPlayerSession->next_udp_send_seq();
+		}
+		sendBatch.headers[msgCnt].handle = handles[i];
+		sendBatch.headers[msgCnt].token = 0;
+		sendBatch.headers[msgCnt].reserved = 0;
+		sendBatch.iov[msgCnt][0].iov_base = &sendBatch.headers[msgCnt];
+		sendBatch.iov[msgCnt][0].iov_len = sizeof(UDP_HEADER);
+		sendBatch.iov[msgCnt][1].iov_base = pMsg;
+		sendBatch.iov[msgCnt][1].iov_len = nLen;
+		memset(&sendBatch.msgs[msgCnt], 0, sizeof(sendBatch.msgs[msgCnt]));
+		sendBatch.msgs[msgCnt].msg_hdr.msg_name = &sendBatch.addrs[msgCnt];
+		sendBatch.msgs[msgCnt].msg_hdr.msg_namelen = sizeof(sendBatch.addrs[msgCnt]);
+		sendBatch.msgs[msgCnt].msg_hdr.msg_iov = sendBatch.iov[msgCnt];
+		sendBatch.msgs[msgCnt].msg_hdr.msg_iovlen = 2;
+		msgCnt++;
+		if (msgCnt == UDP_BATCH) {
+			udpCnt += FlushSend(sendBatch, msgCnt);
+			msgCnt = 0;
+		}
+	}
+	if (msgCnt > 0) {
+		udpCnt += FlushSend(sendBatch, msgCnt);
+	}
+	return udpCnt;
+}
+
+int Udp_Channel::FlushSend(UDP_SendBatch& batch, const int msgCnt)
+{
+	int sentCnt = 0;
+	int offset = 0;
+	while (offset < msgCnt) {
+		int result = sendmmsg(udpSock, &batch.msgs[offset], msgCnt - offset, MSG_DONTWAIT);
+		sendCallCnt.fetch_add(1, std::memory_order_relaxed);
+		if (result < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			if (errno == EAGAIN || errno == EWOULDBLOCK) {
+				// 송신 Buffer 가 가득 찼다. 이동은 다음 이동이 대신 하므로 버린다.
+				sendDropCnt.fetch_add(msgCnt - offset, std::memory_order_relaxed);
+				break;
+			}
+			// 이 datagram 만 버리고 나머지는 계속 보낸다.
+			sendDropCnt.fetch_add(1, std::memory_order_relaxed);
+			offset++;
+			continue;
+		}
+		sentCnt += result;
+		offset += result;
+	}
+	sendDatagramCnt.fetch_add(sentCnt, std::memory_order_relaxed);
+	return sentCnt;
+}
+
+void Udp_Channel::logStats()
+{
+	if (!is_enabled()) {
+		return;
+	}
+	unsigned_int64 recvCnt = recvDatagramCnt.load(std::memory_order_relaxed);
+	unsigned_int64 recvCall = recvCallCnt.load(std::memory_order_relaxed);
+	unsigned_int64 sendCnt = sendDatagramCnt.load(std::memory_order_relaxed);
+	unsigned_int64 sendCall = sendCallCnt.load(std::memory_order_relaxed);
+	spdlog::info("[UDP] recv datagram : {}, recvmmsg : {} ({:.2f} / call), stale drop : {}, invalid drop : {}, paused drop : {}",
+		recvCnt, recvCall, recvCall > 0 ? (double)recvCnt / recvCall : 0.0,
+		staleDropCnt.load(std::memory_order_relaxed), invalidDropCnt.load(std::memory_order_relaxed), pausedDropCnt.load(std::memory_order_relaxed));
+	spdlog::info("[UDP] send datagram : {}, sendmmsg : {} ({:.2f} / call), send drop : {}",
+		sendCnt, sendCall, sendCall > 0 ? (double)sendCnt / sendCall : 0.0, sendDropCnt.load(std::memory_order_relaxed));
+}
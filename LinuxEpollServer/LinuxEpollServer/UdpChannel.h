@@ -0,0 +1,66 @@
+﻿#ifndef __UDP_CHANNEL_H__
+#define __UDP_CHANNEL_H__
+
+#include "Main.h"
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <random>
+
+#define UDP_BATCH 64				// recvmmsg / sendmmsg 한번에 처리하는 datagram 수
+#define UDP_MAX_DATAGRAM 512		// 받는 datagram 최대 크기 (이동 Packet 전용)
+
+// sendmmsg 묶음 (Logic_API shard 마다 thread_local 로 사용)
+struct UDP_SendBatch {
+	struct mmsghdr msgs[UDP_BATCH];
+	struct iovec iov[UDP_BATCH][2];										// UDP_HEADER, Packet
+	struct UDP_HEADER headers[UDP_BATCH];
+	struct sockaddr_in addrs[UDP_BATCH];
+};
+
+// 이동 Packet 전용 UDP 채널 (UDP_PORT > 0)
+// 로그인 응답 (SERVER_AUTH_UNIQUENO) 으로 받은 handle, token 을 datagram 앞에 붙여 세션을 확인한다.
+// 받은 이동은 기존 Logic_API 로 넘기고, 마지막 seq 보다 늦게 도착한 이동은 버린다.
+// 주변 세션 이동은 UDP 주소를 받은 세션만 sendmmsg 로 보내고 나머지는 TCP 로 보낸다.
+class Udp_Channel {
+public:
+	Udp_Channel();
+	~Udp_Channel();
+	bool start(const int port);												// 소켓 bind, 수신 Thread 시작 (0 : 사용 안함)
+	void stop();															// 수신 Thread 종료, 소켓 닫기
+	bool is_enabled() { return udpSock >= 0; }
+	int get_port() { return udpPort; }
+	unsigned_int64 issue_token(const session_handle handle);				// 로그인 시 token 발급 (종료된 세션은 0)
+	int SendMove(const session_handle* handles, const int handleCnt, char* pMsg, int nLen, std::vector<session_handle>& tcpHandles);	// UDP 로 보낸 세션 수 (나머지는 tcpHandles)
+	void logStats();
+
+private:
+	int udpSock;
+	int udpPort;
+	int wakeFd;																// 종료시 수신 Thread 를 깨운다.
+	std::atomic<bool> threadRun;
+	std::thread mRecvThread;
+	std::mt19937_64 tokenRandom;
+	std::mutex mTokenLock;													// Logic_API shard 가 같이 사용
+
+	// 수신 (UDP Thread 에서만 사용)
+	char recvBuf[UDP_BATCH][UDP_MAX_DATAGRAM];
+	struct mmsghdr recvMsgs[UDP_BATCH];
+	struct iovec recvIov[UDP_BATCH];
+	struct sockaddr_in recvAddrs[UDP_BATCH];
+
+	std::atomic<unsigned_int64> recvDatagramCnt;							// 받은 datagram 수
+	std::atomic<unsigned_int64> recvCallCnt;								// recvmmsg syscall 수
+	std::atomic<unsigned_int64> staleDropCnt;								// seq 가 늦어서 버린 수
+	std::atomic<unsigned_int64> invalidDropCnt;								// handle / token / Packet 이 잘못되어 버린 수
+	std::atomic<unsigned_int64> pausedDropCnt;								// 수신 중단 세션 이라 버린 수
+	std::atomic<unsigned_int64> sendDatagramCnt;							// 보낸 datagram 수
+	std::atomic<unsigned_int64> sendCallCnt;								// sendmmsg syscall 수
+	std::atomic<unsigned_int64> sendDropCnt;								// 보내지 못한 datagram 수 (EAGAIN ...)
+
+	void RecvThread();
+	void OnDatagram(char* pData, const int size, const struct sockaddr_in& addr);
+	int FlushSend(UDP_SendBatch& batch, const int msgCnt);					// sendmmsg 로 msgCnt 개를 보낸다.
+};
+
+#endif
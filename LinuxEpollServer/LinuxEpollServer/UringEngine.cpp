@@ -0,0 +1,541 @@
+﻿#include "UringEngine.h"
+
+#include <sys/eventfd.h>
+#include <poll.h>
+
+Uring_Engine::Uring_Engine()
+{
+#ifdef USE_IO_URING
+	memset(&ring, 0, sizeof ring);
+	bufRing = nullptr;
+#endif
+	bufBase = nullptr;
+	listenSock = -1;
+	wakeFd = -1;
+	wakeValue = 0;
+	mIsEngineRun = false;
+	draining = false;
+	recvArmed = 0;
+	enterCnt = 0;
+	recvCnt = 0;
+	acceptCnt = 0;
+}
+
+Uring_Engine::~Uring_Engine()
+{
+}
+
+bool Uring_Engine::init_engine(int port)
+{
+#ifdef USE_IO_URING
+	if (CS.get_max_player() >= (1 << URING_SLOT_BITS)) {
+		spdlog::error("[Uring] MAX_PLAYER({}) exceeds user_data slot range ({})", CS.get_max_player(), 1 << URING_SLOT_BITS);
+		return false;
+	}
+	if (!init_ring()) {
+		return false;
+	}
+
+	if ((wakeFd = eventfd(0, EFD_CLOEXEC)) < 0) {
+		spdlog::error("[Uring] eventfd() Function failure");
+		return false;
+	}
+
+	// Hot Restart 로 넘겨 받은 Listen 소켓은 이미 bind, listen 되어 있다.
+	if ((listenSock = hotRestart.take_listen_sock()) >= 0) {
+		return true;
+	}
+
+	if ((listenSock = socket(PF_INET, SOCK_STREAM, 0)) < 0) {
+		spdlog::error("[Uring] socket() Function failure");
+		return false;
+	}
+
+	int option = 1;
+	setsockopt(listenSock, SOL_SOCKET, SO_REUSEADDR, &option, sizeof option);
+
+	struct sockaddr_in sin;
+	memset(&sin, 0, sizeof sin);
+	sin.sin_family = AF_INET;
+	sin.sin_addr.s_addr = htonl(INADDR_ANY);
+	sin.sin_port = htons(port);
+
+	if (bind(listenSock, (struct sockaddr *) &sin, sizeof sin) < 0) {
+		spdlog::error("[Uring] bind() Function failure");
+		return false;
+	}
+
+	if (!epoll_server.ListenSocket(listenSock)) {
+		spdlog::error("[Uring] listen() Function failure");
+		return false;
+	}
+	return true;
+#else
+	(void)port;
+	spdlog::error("[Uring] io_uring is not supported in this build (USE_IO_URING)");
+	return false;
+#endif
+}
+
+bool Uring_Engine::init_ring()
+{
+#ifdef USE_IO_URING
+	int ret = io_uring_queue_init(URING_ENTRIES, &ring, 0);
+	if (ret < 0) {
+		spdlog::error("[Uring] io_uring_queue_init() Function failure : {}", strerror(-ret));
+		return false;
+	}
+
+	// recv 는 커널이 Provided Buffer 중 하나를 골라서 채운다.
+	bufRing = io_uring_setup_buf_ring(&ring, URING_BUF_CNT, URING_BUF_GROUP, 0, &ret);
+	if (bufRing == nullptr) {
+		spdlog::error("[Uring] io_uring_setup_buf_ring() Function failure : {}", strerror(-ret));
+		io_uring_queue_exit(&ring);
+		return false;
+	}
+	bufBase = new char[URING_BUF_CNT * MAX_SOCKBUF];
+	for (int i = 0; i < URING_BUF_CNT; i++) {
+		io_uring_buf_ring_add(bufRing, bufBase + i * MAX_SOCKBUF, MAX_SOCKBUF, i, io_uring_buf_ring_mask(URING_BUF_CNT), i);
+	}
+	io_uring_buf_ring_advance(bufRing, URING_BUF_CNT);
+	return true;
+#else
+	return false;
+#endif
+}
+
+void Uring_Engine::start()
+{
+	mIsEngineRun = true;
+	mEngineThread = std::thread([this]() { EngineThread(); });
+}
+
+void Uring_Engine::stop()
+{
+	mIsEngineRun = false;
+	if (wakeFd >= 0) {
+		uint64_t value = 1;
+		if (write(wakeFd, &value, sizeof value) < 0) {
+			// counter overflow
+		}
+	}
+	if (mEngineThread.joinable()) {
+		mEngineThread.join();
+	}
+}
+
+bool Uring_Engine::resume()
+{
+	// stop 에서 ring 을 닫았으므로 새로 만들고, 취소된 recv 와 등록되어 있던 POLLOUT 을 다시 등록한다.
+	if (!init_ring()) {
+		return false;
+	}
+	draining = false;
+	recvArmed = 0;
+	start();
+	for (int slot = 0; slot < epoll_server.get_max_session(); slot++) {
+		auto pPlayerSession = epoll_server.getSessionBySlot(slot);
+		if (pPlayerSession == nullptr) continue;
+		session_handle handle;
+		bool paused;
+		bool armed;
+		{
+			std::lock_guard<std::mutex> sendGuard(pPlayerSession->send_mutex());
+			handle = pPlayerSession->get_handle();
+			paused = pPlayerSession->get_readPaused();
+			armed = pPlayerSession->get_sendArmed();
+		}
+		if (!paused) {
+			requestRecvCtl(handle, false);
+		}
+		if (armed) {
+			requestPollOut(handle);
+		}
+	}
+	return true;
+}
+
+void Uring_Engine::close_listen()
+{
+	if (listenSock >= 0) {
+		close(listenSock);
+		listenSock = -1;
+	}
+}
+
+void Uring_Engine::requestPollOut(const session_handle handle)
+{
+	// SQ 는 Engine Thread 만 사용하므로 Queue 에 넣고 깨운다.
+	pollOutQueue.push(handle);
+	uint64_t value = 1;
+	if (write(wakeFd, &value, sizeof value) < 0) {
+		// counter overflow (이미 깨어 있다)
+	}
+}
+
+void Uring_Engine::requestRecvCtl(const session_handle handle, const bool pause)
+{
+	// 요청 순서대로 처리 되도록 하나의 Queue 를 사용한다.
+	URING_RecvCtl ctl;
+	ctl.handle = handle;
+	ctl.pause = pause;
+	recvCtlQueue.push(ctl);
+	uint64_t value = 1;
+	if (write(wakeFd, &value, sizeof value) < 0) {
+		// counter overflow (이미 깨어 있다)
+	}
+}
+
+void Uring_Engine::logStats()
+{
+	spdlog::info("[Uring] io_uring_enter : {}, recv cqe : {}, accept : {}", enterCnt.load(), recvCnt.load(), acceptCnt.load());
+}
+
+void Uring_Engine::EngineThread()
+{
+	topology.bind_thread(THREAD_EVENT, 0);
+#ifdef USE_IO_URING
+	struct io_uring_cqe *cqes[URING_CQE_BATCH];
+	prepAccept();
+	prepWake();
+	prepTimer();
+
+	while (mIsEngineRun)
+	{
+		// 쌓인 SQE 제출 + CQE 대기를 syscall 한번으로 처리한다.
+		int ret = io_uring_submit_and_wait(&ring, 1);
+		enterCnt.fetch_add(1, std::memory_order_relaxed);
+		if (ret < 0 && ret != -EINTR) {
+			spdlog::error("[Uring] io_uring_submit_and_wait() Function failure : {}", strerror(-ret));
+			continue;
+		}
+
+		unsigned cqeCnt = io_uring_peek_batch_cqe(&ring, cqes, URING_CQE_BATCH);
+		for (unsigned i = 0; i < cqeCnt; i++) {
+			uint64_t data = io_uring_cqe_get_data64(cqes[i]);
+			int op = URING_USER_OP(data);
+			session_handle handle = URING_USER_HANDLE(data);
+
+			switch (op) {
+			case URING_OP_ACCEPT:
+				OnAccept(cqes[i]->res, cqes[i]->flags);
+				break;
+			case URING_OP_RECV:
+				if (!(cqes[i]->flags & IORING_CQE_F_MORE)) {
+					recvArmed--;
+				}
+				OnRecvComplete(handle, cqes[i]->res, cqes[i]->flags);
+				break;
+			case URING_OP_POLLOUT:
+				OnPollOut(handle);
+				break;
+			case URING_OP_WAKE:
+			{
+				// 다른 Thread 에서 요청한 POLLOUT 등록
+				session_handle pollHandle;
+				while (pollOutQueue.tryPop(pollHandle)) {
+					prepPollOut(pollHandle);
+				}
+				URING_RecvCtl ctl;
+				while (recvCtlQueue.tryPop(ctl)) {
+					if (ctl.pause) {
+						prepCancelRecv(ctl.handle);
+						continue;
+					}
+					// 그 사이 종료된 세션은 다시 등록하지 않는다.
+					auto pPlayerSession = epoll_server.getSessionByHandle(ctl.handle);
+					if (pPlayerSession != nullptr) {
+						prepRecv(pPlayerSession->get_sock(), ctl.handle);
+					}
+				}
+				prepWake();
+			}
+			break;
+			case URING_OP_TIMER:
+				timer.OnTick();
+				prepTimer();
+				break;
+			case URING_OP_CANCEL:
+				// 취소 결과 (recv 쪽에서 -ECANCELED 로 끝난다)
+				break;
+			default:
+				spdlog::error("[Uring] Unknown user_data op ({})", op);
+				break;
+			}
+		}
+		io_uring_cq_advance(&ring, cqeCnt);
+	}
+
+	// Provided Buffer 에 받았지만 처리하지 않은 데이터가 ring 과 같이 사라지지 않도록 먼저 처리한다.
+	DrainRecv();
+	io_uring_free_buf_ring(&ring, bufRing, URING_BUF_CNT, URING_BUF_GROUP);
+	io_uring_queue_exit(&ring);
+	delete[] bufBase;
+	bufBase = nullptr;
+#endif
+}
+
+void Uring_Engine::DrainRecv()
+{
+#ifdef USE_IO_URING
+	// 취소 이후 도착한 데이터는 소켓에 남아 있으므로 (Hot Restart) 다음 프로세스가 이어서 읽는다.
+	draining = true;
+	struct io_uring_sqe *sqe = getSqe();
+	io_uring_prep_cancel64(sqe, 0, IORING_ASYNC_CANCEL_ALL | IORING_ASYNC_CANCEL_ANY);
+	io_uring_sqe_set_data64(sqe, URING_USER_DATA(URING_OP_CANCEL, 0ULL));
+
+	struct io_uring_cqe *cqes[URING_CQE_BATCH];
+	bool cancelDone = false;
+	while (recvArmed > 0 || !cancelDone) {
+		int ret = io_uring_submit_and_wait(&ring, 1);
+		enterCnt.fetch_add(1, std::memory_order_relaxed);
+		if (ret < 0 && ret != -EINTR) {
+			spdlog::error("[Uring] drain io_uring_submit_and_wait() Function failure : {}", strerror(-ret));
+			break;
+		}
+		unsigned cqeCnt = io_uring_peek_batch_cqe(&ring, cqes, URING_CQE_BATCH);
+		for (unsigned i = 0; i < cqeCnt; i++) {
+			uint64_t data = io_uring_cqe_get_data64(cqes[i]);
+			int op = URING_USER_OP(data);
+			if (op == URING_OP_RECV) {
+				// 세션 ReadBuffer (완성되지 않은 조각), Logic_API (완성된 Packet) 로 옮긴다.
+				if (!(cqes[i]->flags & IORING_CQE_F_MORE)) {
+					recvArmed--;
+				}
+				OnRecvComplete(URING_USER_HANDLE(data), cqes[i]->res, cqes[i]->flags);
+			}
+			else if (op == URING_OP_CANCEL && URING_USER_HANDLE(data) == 0) {
+				cancelDone = true;
+				if (cqes[i]->res < 0 && cqes[i]->res != -ENOENT) {
+					// 전체 취소를 지원하지 않는 커널 : 처리하지 못한 데이터는 버려진다.
+					spdlog::error("[Uring] cancel all failure : {} (recv armed : {})", strerror(-cqes[i]->res), recvArmed);
+					recvArmed = 0;
+				}
+			}
+			// accept, POLLOUT, 타이머 의 취소 결과는 무시한다.
+		}
+		io_uring_cq_advance(&ring, cqeCnt);
+	}
+	spdlog::info("[Uring] recv drained");
+#endif
+}
+
+#ifdef USE_IO_URING
+struct io_uring_sqe * Uring_Engine::getSqe()
+{
+	struct io_uring_sqe *sqe = io_uring_get_sqe(&ring);
+	if (sqe == nullptr) {
+		// SQ 가 가득 찼다 -> 먼저 제출 한다.
+		io_uring_submit(&ring);
+		enterCnt.fetch_add(1, std::memory_order_relaxed);
+		sqe = io_uring_get_sqe(&ring);
+	}
+	return sqe;
+}
+#endif
+
+void Uring_Engine::prepAccept()
+{
+#ifdef USE_IO_URING
+	struct io_uring_sqe *sqe = getSqe();
+	io_uring_prep_multishot_accept(sqe, listenSock, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+	io_uring_sqe_set_data64(sqe, URING_USER_DATA(URING_OP_ACCEPT, 0ULL));
+#endif
+}
+
+void Uring_Engine::prepRecv(const int sock, const session_handle handle)
+{
+#ifdef USE_IO_URING
+	struct io_uring_sqe *sqe = getSqe();
+	io_uring_prep_recv_multishot(sqe, sock, NULL, 0, 0);
+	sqe->flags |= IOSQE_BUFFER_SELECT;
+	sqe->buf_group = URING_BUF_GROUP;
+	io_uring_sqe_set_data64(sqe, URING_USER_DATA(URING_OP_RECV, handle));
+	recvArmed++;
+#else
+	(void)sock;
+	(void)handle;
+#endif
+}
+
+void Uring_Engine::prepPollOut(const session_handle handle)
+{
+#ifdef USE_IO_URING
+	// 요청 후 종료된 세션은 등록하지 않는다.
+	auto pPlayerSession = epoll_server.getSessionByHandle(handle);
+	if (pPlayerSession == nullptr) return;
+	struct io_uring_sqe *sqe = getSqe();
+	io_uring_prep_poll_add(sqe, pPlayerSession->get_sock(), POLLOUT);
+	io_uring_sqe_set_data64(sqe, URING_USER_DATA(URING_OP_POLLOUT, handle));
+#else
+	(void)handle;
+#endif
+}
+
+void Uring_Engine::prepWake()
+{
+#ifdef USE_IO_URING
+	struct io_uring_sqe *sqe = getSqe();
+	io_uring_prep_read(sqe, wakeFd, &wakeValue, sizeof wakeValue, 0);
+	io_uring_sqe_set_data64(sqe, URING_USER_DATA(URING_OP_WAKE, 0ULL));
+#endif
+}
+
+void Uring_Engine::prepCancelRecv(const session_handle handle)
+{
+#ifdef USE_IO_URING
+	struct io_uring_sqe *sqe = getSqe();
+	io_uring_prep_cancel64(sqe, URING_USER_DATA(URING_OP_RECV, handle), 0);
+	io_uring_sqe_set_data64(sqe, URING_USER_DATA(URING_OP_CANCEL, handle));
+#else
+	(void)handle;
+#endif
+}
+
+void Uring_Engine::prepTimer()
+{
+#ifdef USE_IO_URING
+	if (timer.get_fd() < 0) return;
+	struct io_uring_sqe *sqe = getSqe();
+	io_uring_prep_poll_add(sqe, timer.get_fd(), POLLIN);
+	io_uring_sqe_set_data64(sqe, URING_USER_DATA(URING_OP_TIMER, 0ULL));
+#endif
+}
+
+void Uring_Engine::recycleBuffer(const unsigned short bid)
+{
+#ifdef USE_IO_URING
+	io_uring_buf_ring_add(bufRing, bufBase + bid * MAX_SOCKBUF, MAX_SOCKBUF, bid, io_uring_buf_ring_mask(URING_BUF_CNT), 0);
+	io_uring_buf_ring_advance(bufRing, 1);
+#else
+	(void)bid;
+#endif
+}
+
+void Uring_Engine::OnAccept(const int res, const unsigned flags)
+{
+#ifdef USE_IO_URING
+	// multishot 이 끝난 경우 다시 등록한다.
+	if (!(flags & IORING_CQE_F_MORE)) {
+		prepAccept();
+	}
+	if (res < 0) {
+		spdlog::error("[Uring] accept Error : {}", strerror(-res));
+		return;
+	}
+
+	struct sockaddr_in client_addr;
+	socklen_t client_addr_len = sizeof client_addr;
+	memset(&client_addr, 0, sizeof client_addr);
+	getpeername(res, (struct sockaddr *) &client_addr, &client_addr_len);
+
+	if (epoll_server.RegisterSession(res, client_addr, URING_REACTOR_NO)) {
+		acceptCnt.fetch_add(1, std::memory_order_relaxed);
+		auto pPlayerSession = epoll_server.getSessionByNo(res);
+		if (pPlayerSession != nullptr) {
+			prepRecv(res, pPlayerSession->get_handle());
+		}
+	}
+#else
+	(void)res;
+	(void)flags;
+#endif
+}
+
+void Uring_Engine::OnRecvComplete(const session_handle handle, const int res, const unsigned flags)
+{
+#ifdef USE_IO_URING
+	// 종료 (fd 재사용) 된 세션의 늦은 CQE 는 generation 이 달라서 nullptr 이다.
+	auto pPlayerSession = epoll_server.getSessionByHandle(handle);
+	if (res == -ENOBUFS) {
+		// Provided Buffer 가 모두 사용중이다 -> 다시 등록한다.
+		if (!(flags & IORING_CQE_F_MORE) && pPlayerSession != nullptr && !draining) {
+			prepRecv(pPlayerSession->get_sock(), handle);
+		}
+		return;
+	}
+	if (res == -ECANCELED) {
+		// 수신 중단 (requestRecvCtl) 으로 취소 되었다. 재개 할 때 다시 등록한다.
+		return;
+	}
+	if (res <= 0) {
+		if (pPlayerSession != nullptr) {
+			spdlog::info("[Disconnect] URING RECV SOCKET : {}, res : {} || [unique_no:{}]", (int)pPlayerSession->get_sock(), res, (int)pPlayerSession->get_unique_no());
+			epoll_server.ClosePlayer(handle);
+		}
+		return;
+	}
+	recvCnt.fetch_add(1, std::memory_order_relaxed);
+
+	unsigned short bid = flags >> IORING_CQE_BUFFER_SHIFT;
+	char *pData = bufBase + bid * MAX_SOCKBUF;
+	bool closed = pPlayerSession == nullptr;
+	if (!closed) {
+		// ReadBuffer 로 옮긴 뒤 기존 OnRecv 로 Packet 을 나눈다.
+		int sock = pPlayerSession->get_sock();
+		int offset = 0;
+		while (offset < res) {
+			Chain_Buffer* pChain = pPlayerSession->get_chain();
+			if (pChain != nullptr) {
+				// 큰 Packet 을 받는 중 : Packet 끝 까지만 block 으로 복사한다.
+				offset += pChain->append(pData + offset, res - offset);
+				if (!epoll_server.OnRecvChain(pPlayerSession)) {
+					closed = true;
+					break;
+				}
+				continue;
+			}
+			if (CS.get_shared_recv_buffer() && pPlayerSession->read_buffer().getReadAbleSize() == 0) {
+				// 남은 조각이 없으면 provided buffer 에서 바로 나누고, 남은 조각만 ReadBuffer 로 옮긴다.
+				closed = !epoll_server.OnRecvShared(pPlayerSession, pData + offset, res - offset);
+				break;
+			}
+			pPlayerSession->read_buffer().checkWrite(MIN_SOCKBUF);
+			int copySize = std::min(res - offset, pPlayerSession->read_buffer().getWriteAbleSize());
+			if (copySize <= 0) {
+				spdlog::error("ReadBuffer Over Flow || [unique_no:{}]", pPlayerSession->get_unique_no());
+				break;
+			}
+			memcpy(pPlayerSession->read_buffer().getWriteBuffer(), pData + offset, copySize);
+			if (!epoll_server.OnRecv(sock, copySize)) {
+				closed = true;
+				break;
+			}
+			offset += copySize;
+		}
+		if (closed) {
+			epoll_server.ClosePlayer(handle);
+		}
+		else {
+			// 다 읽은 Buffer 는 Pool 로 돌려준다.
+			pPlayerSession->read_buffer().releaseIfEmpty();
+		}
+	}
+	recycleBuffer(bid);
+
+	// 수신 중단 중에는 다시 등록하지 않는다. (재개 요청에서 등록), 닫은 세션은 fd 가 재사용 될 수 있으므로 등록하지 않는다.
+	if (!(flags & IORING_CQE_F_MORE) && !closed && !draining && !pPlayerSession->get_readPaused()) {
+		prepRecv(pPlayerSession->get_sock(), handle);
+	}
+#else
+	(void)handle;
+	(void)res;
+	(void)flags;
+#endif
+}
+
+void Uring_Engine::OnPollOut(const session_handle handle)
+{
+	auto pPlayerSession = epoll_server.getSessionByHandle(handle);
+	if (pPlayerSession == nullptr) return;
+
+	// POLLOUT 은 1회성 이므로 등록 상태를 풀고 남은 sendQueue 를 보낸다.
+	std::unique_lock<std::mutex> sendGuard(pPlayerSession->send_mutex());
+	if (pPlayerSession->get_handle() != handle) return;
+	pPlayerSession->set_sendArmed(false);
+	if (!epoll_server.FlushSend(pPlayerSession)) {
+		sendGuard.unlock();
+		spdlog::info("[Disconnect] URING POLLOUT SOCKET : {} || [unique_no:{}]", (int)pPlayerSession->get_sock(), (int)pPlayerSession->get_unique_no());
+		epoll_server.ClosePlayer(handle);
+	}
+}
@@ -0,0 +1,95 @@
+﻿#ifndef __URING_ENGINE_H__
+#define __URING_ENGINE_H__
+
+#include "Main.h"
+
+#include <atomic>
+#include <stdint.h>
+#ifdef USE_IO_URING
+#include <liburing.h>
+#endif
+
+#define URING_ENTRIES 4096		// Submission Queue 크기
+#define URING_BUF_CNT 1024		// Provided Buffer 수 (2의 제곱수)
+#define URING_BUF_GROUP 0		// Provided Buffer Group ID
+#define URING_CQE_BATCH 256		// 한번에 처리하는 CQE 수
+#define URING_POLLOUT_QUEUE 4096	// POLLOUT 등록 요청 Queue 크기
+#define URING_SLOT_BITS 24			// user_data 에 넣는 세션 slot bit 수 (MAX_PLAYER 상한)
+
+// user_data : generation (32bit) | 요청 종류 (8bit) | slot (24bit)
+// fd 는 닫은 뒤 바로 재사용 되므로 세션 핸들로 완료를 찾는다. (늦게 온 CQE 는 generation 이 달라서 버린다)
+#define URING_USER_DATA(op, handle) (((handle) & 0xffffffff00000000ULL) | ((uint64_t)(op) << URING_SLOT_BITS) | ((handle) & ((1u << URING_SLOT_BITS) - 1)))
+#define URING_USER_OP(data) ((int)(((data) >> URING_SLOT_BITS) & 0xff))
+#define URING_USER_HANDLE(data) ((data) & ~((uint64_t)0xff << URING_SLOT_BITS))
+
+// user_data 에 넣는 요청 종류
+enum URING_OP {
+	URING_OP_ACCEPT = 1,
+	URING_OP_RECV,
+	URING_OP_POLLOUT,
+	URING_OP_WAKE,
+	URING_OP_TIMER,
+	URING_OP_CANCEL
+};
+
+// 수신 중단 / 재개 요청 (다른 Thread -> Engine Thread)
+struct URING_RecvCtl {
+	session_handle handle;
+	bool pause;
+};
+
+// io_uring 기반 I/O 엔진 (IO_ENGINE=uring)
+// multishot accept, multishot recv + Provided Buffer Ring 으로 accept / recv 를 syscall 없이 받는다.
+// 받은 데이터는 기존 ReadBuffer -> OnRecv -> Logic_API 흐름을 그대로 사용한다.
+class Uring_Engine {
+public:
+	Uring_Engine();
+	~Uring_Engine();
+	bool init_engine(int port);											// ring 생성, Provided Buffer 등록, Listen
+	void start();
+	void stop();
+	bool resume();														// stop 이후 ring 을 다시 만들고 세션 recv / POLLOUT 재등록 (Hot Restart 실패)
+	void close_listen();
+	int get_listen_sock() { return listenSock; }
+	void requestPollOut(const session_handle handle);					// EPOLLOUT 대신 POLLOUT 1회 등록 (다른 Thread)
+	void requestRecvCtl(const session_handle handle, const bool pause);	// EPOLLIN 제거 대신 multishot recv 취소 / 재등록
+	void logStats();
+
+private:
+#ifdef USE_IO_URING
+	struct io_uring ring;
+	struct io_uring_buf_ring *bufRing;
+#endif
+	char *bufBase;														// Provided Buffer 메모리
+	int listenSock;
+	int wakeFd;															// 다른 Thread 요청 알림 eventfd
+	uint64_t wakeValue;
+	LockFreeQueue<session_handle> pollOutQueue{ URING_POLLOUT_QUEUE };	// POLLOUT 등록 요청
+	LockFreeQueue<URING_RecvCtl> recvCtlQueue{ URING_POLLOUT_QUEUE };	// 수신 중단 / 재개 요청
+	bool mIsEngineRun;
+	bool draining;														// 종료 중 : recv 를 다시 등록하지 않는다.
+	int recvArmed;														// 등록 되어 있는 multishot recv 수 (Engine Thread)
+	std::thread mEngineThread;
+	std::atomic<unsigned_int64> enterCnt;								// io_uring_enter 호출 수
+	std::atomic<unsigned_int64> recvCnt;								// recv CQE 수
+	std::atomic<unsigned_int64> acceptCnt;								// accept 수
+
+	void EngineThread();												// Engine Thread Function
+	bool init_ring();													// ring 생성, Provided Buffer 등록
+	void DrainRecv();													// 종료 전 multishot recv 취소, 받은 CQE 를 모두 처리
+#ifdef USE_IO_URING
+	struct io_uring_sqe * getSqe();
+#endif
+	void prepAccept();
+	void prepRecv(const int sock, const session_handle handle);
+	void prepPollOut(const session_handle handle);
+	void prepWake();
+	void prepCancelRecv(const session_handle handle);					// multishot recv 취소
+	void prepTimer();													// timerfd POLLIN 1회 등록
+	void recycleBuffer(const unsigned short bid);
+	void OnAccept(const int res, const unsigned flags);
+	void OnRecvComplete(const session_handle handle, const int res, const unsigned flags);
+	void OnPollOut(const session_handle handle);
+};
+
+#endif
@@ -0,0 +1,78 @@
+﻿#ifndef __WAITPOLICY_H__
+#define __WAITPOLICY_H__
+
+#include "LockFreeQueue.h"
+
+#include <chrono>
+#include <sys/epoll.h>
+
+// Reactor, Logic_API 의 대기 방식 (WAIT_STRATEGY)
+// Thread 시작 시 한번 골라서 Loop 를 해당 Policy 로 만든다. (기본 Block_Wait 은 기존 Loop 와 같은 코드)
+
+// 대기 중 CPU 에 양보 (hyper-thread 상대 코어, 전력)
+static inline void cpu_relax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#elif defined(__aarch64__)
+	asm volatile("yield");
+#endif
+}
+
+// block : 이벤트가 올 때 까지 잠든다.
+struct Block_Wait {
+	explicit Block_Wait(const int) {}
+	int wait_epoll(int epfd, struct epoll_event* events, const int maxCnt) {
+		return epoll_wait(epfd, events, maxCnt, -1);
+	}
+	template <typename T>
+	int pop(LockFreeQueue<T>& queue, T* out, const int maxCnt) {
+		return queue.popBatch(out, maxCnt);
+	}
+};
+
+// spin : spinUsec 동안 잠들지 않고 확인한 뒤 잠든다.
+struct Spin_Wait {
+	explicit Spin_Wait(const int spinUsec) : spinTime(std::chrono::microseconds(spinUsec)) {}
+	int wait_epoll(int epfd, struct epoll_event* events, const int maxCnt) {
+		auto begin = std::chrono::steady_clock::now();
+		do {
+			int nfds = epoll_wait(epfd, events, maxCnt, 0);
+			if (nfds != 0) return nfds;
+			cpu_relax();
+		} while (std::chrono::steady_clock::now() - begin < spinTime);
+		return epoll_wait(epfd, events, maxCnt, -1);
+	}
+	template <typename T>
+	int pop(LockFreeQueue<T>& queue, T* out, const int maxCnt) {
+		auto begin = std::chrono::steady_clock::now();
+		do {
+			int cnt = queue.tryPopBatch(out, maxCnt);
+			if (cnt > 0) return cnt;
+			cpu_relax();
+		} while (std::chrono::steady_clock::now() - begin < spinTime);
+		return queue.popBatch(out, maxCnt);
+	}
+
+private:
+	std::chrono::steady_clock::duration spinTime;
+};
+
+// busy : 잠들지 않는다. 이벤트가 없으면 0 을 반환하여 호출한 Loop 가 종료 요청을 확인하도록 한다.
+// 소켓에는 SO_BUSY_POLL (BUSY_POLL_USEC) 을 설정한다.
+struct Busy_Poll {
+	explicit Busy_Poll(const int) {}
+	int wait_epoll(int epfd, struct epoll_event* events, const int maxCnt) {
+		int nfds = epoll_wait(epfd, events, maxCnt, 0);
+		if (nfds == 0) cpu_relax();
+		return nfds;
+	}
+	template <typename T>
+	int pop(LockFreeQueue<T>& queue, T* out, const int maxCnt) {
+		int cnt = queue.tryPopBatch(out, maxCnt);
+		if (cnt == 0) cpu_relax();
+		return cnt;
+	}
+};
+
+#endif
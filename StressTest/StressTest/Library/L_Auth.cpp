@@ -22,6 +22,14 @@ void AuthRoute::ApiProcessing(Packet_Frame packet)
 	}
 	break;
 
+	case SERVER_AUTH_MOVE:
+	{
+		// 주변 플레이어 이동 (TCP / UDP 같은 경로로 온다)
+		sc_packet_move *my_packet = reinterpret_cast<sc_packet_move *>(packet.pMsg);
+		moveLatency.onRecv(my_packet->unique_no);
+	}
+	break;
+
 	default:
 	{
 		spdlog::error("L_Auth->ApiProcessing ProtocolType ({})is not found..! || [unique_no:{}]", packet.packet_type, packet.unique_no);
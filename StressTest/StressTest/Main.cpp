@@ -5,8 +5,11 @@
 std::vector<class IOCP_Client *> vIocpClient;
 class Logic_API api;
 class PLAYER *Player;
+class Move_Latency moveLatency;
 
-int main() {
+int main(int argc, char* argv[]) {
+	// "udp" 를 주면 이동 Packet 을 UDP 로 보낸다. (TCP 와 지연 시간 비교)
+	bool udpMode = (argc > 1 && strcmp(argv[1], "udp") == 0);
 
 	// Create
 	vIocpClient.clear();
@@ -43,12 +46,21 @@ int main() {
 			sendPacket2.packet_type = CLIENT_AUTH_TEST;
 			sendPacket2.dir.x = 06;
 			sendPacket2.dir.y = 16;
-			vIocpClient[k]->SendPacket(reinterpret_cast<char *>(&sendPacket2), sizeof(sendPacket2));
+			moveLatency.onSend(vIocpClient[k]->get_unique_no());
+			if (udpMode && vIocpClient[k]->get_udpReady()) {
+				vIocpClient[k]->SendMoveUdp(reinterpret_cast<char *>(&sendPacket2), sizeof(sendPacket2));
+			}
+			else {
+				vIocpClient[k]->SendPacket(reinterpret_cast<char *>(&sendPacket2), sizeof(sendPacket2));
+			}
 			++k;
 		}
 		Sleep(10);
 	}
 
+	// 마지막 이동이 도착할 때 까지 기다린 후 출력한다.
+	Sleep(1000);
+	moveLatency.print(udpMode ? "UDP" : "TCP");
 
 	getchar();
 }
@@ -20,6 +20,7 @@
 #include <chrono>
 #include <queue>
 #include <mutex>
+#include <atomic>
 
 // SPDLog 1.5.0 <2020.01.21> github Include Add
 #include "spdlog/spdlog.h"
@@ -30,6 +31,7 @@
 #include "iocpClient.h"
 #include "Protocol.h"
 #include "Object.h"
+#include "MoveLatency.h"
 #include "Library/Api.h"
 
 #define SERVERPORT 9001
@@ -38,4 +40,5 @@ const char ipAddres[MAX_SOCKBUF]{ "192.168.56.43" };
 extern std::vector<class IOCP_Client *> vIocpClient;
 extern class Logic_API api;
 extern class PLAYER *Player;
+extern class Move_Latency moveLatency;
 #endif
\ No newline at end of file
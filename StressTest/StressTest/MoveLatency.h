@@ -0,0 +1,56 @@
+﻿#ifndef __MOVE_LATENCY_H__
+#define __MOVE_LATENCY_H__
+
+#include "Main.h"
+#include <algorithm>
+
+// 이동 Packet 지연 시간 (TCP / UDP 비교)
+// 모든 연결이 한 프로세스에 있으므로, 보낸 플레이어의 마지막 전송 시간과 주변 플레이어가 받은 시간의 차이를 잰다.
+class Move_Latency {
+public:
+	void onSend(const unsigned __int64 uniqueNo) {
+		std::lock_guard<std::mutex> guard(mLock);
+		sendTime[uniqueNo] = std::chrono::steady_clock::now();
+	}
+	void onRecv(const unsigned __int64 uniqueNo) {
+		auto now = std::chrono::steady_clock::now();
+		std::lock_guard<std::mutex> guard(mLock);
+		auto iter = sendTime.find(uniqueNo);
+		if (iter == sendTime.end()) {
+			return;
+		}
+		long long us = std::chrono::duration_cast<std::chrono::microseconds>(now - iter->second).count();
+		recvCnt++;
+		totalUs += us;
+		samples.push_back(us);
+		if (us > maxUs) maxUs = us;
+	}
+	void onStale() {
+		std::lock_guard<std::mutex> guard(mLock);
+		staleCnt++;
+	}
+	// 서버 WAIT_STRATEGY 별 비교는 p50 / p99 를 본다.
+	void print(const char* mode) {
+		std::lock_guard<std::mutex> guard(mLock);
+		std::sort(samples.begin(), samples.end());
+		spdlog::info("[{}] move recv : {}, avg : {} us, p50 : {} us, p99 : {} us, max : {} us, stale drop : {}",
+			mode, recvCnt, recvCnt > 0 ? totalUs / recvCnt : 0, percentile(0.50), percentile(0.99), maxUs, staleCnt);
+	}
+
+private:
+	std::mutex mLock;
+	std::unordered_map<unsigned __int64, std::chrono::steady_clock::time_point> sendTime;	// 플레이어 별 마지막 이동 전송 시간
+	long long recvCnt = 0;
+	long long totalUs = 0;
+	long long maxUs = 0;
+	long long staleCnt = 0;				// 늦게 도착해서 버린 UDP 이동 수
+	std::vector<long long> samples;		// 수신 별 지연 시간 (us)
+	long long percentile(const double p) {
+		// samples 는 정렬된 상태
+		if (samples.empty()) return 0;
+		size_t idx = (size_t)(p * (samples.size() - 1));
+		return samples[idx];
+	}
+};
+
+#endif
@@ -32,6 +32,7 @@ const enum ProtocolType {
 	CLIENT_AUTH_TEST2,
 	CLIENT_AUTH_TEST3,
 	CLIENT_AUTH_TEST4,
+	CLIENT_AUTH_PONG,
 
 	// Front
 	CLIENT_FRONT = CLIENT_FRONT_BASE,
@@ -63,6 +64,8 @@ const enum ProtocolType {
 	// Auth
 	SERVER_AUTH = SERVER_AUTH_BASE,
 	SERVER_AUTH_UNIQUENO,
+	SERVER_AUTH_PING,
+	SERVER_AUTH_MOVE,
 
 	// Front
 	SERVER_FRONT = SERVER_FRONT_BASE,
@@ -97,6 +100,16 @@ struct Packet_Frame {
 	char* pMsg = nullptr;
 };
 
+// UDP datagram  κ (ڿ Packet 1 ̾)
+// Ŭ ->  : α   handle, token /  -> Ŭ : handle  ޴ , token  0
+// seq  1  ϰ,  seq ϴ ʰ  ̵ ̹Ƿ .
+struct UDP_HEADER {
+	unsigned __int64 handle;
+	unsigned __int64 token;
+	unsigned int seq;
+	unsigned int reserved;
+};
+
 // Ÿ̸ Ÿ
 enum TimerType {
 	T_NormalTime,
@@ -112,6 +125,10 @@ struct cs_packet_dir : public PACKET_HEADER {
 	Location dir;
 };
 
+struct cs_packet_pong : public PACKET_HEADER {
+	unsigned __int64 server_tick;	//  sc_packet_ping 
+};
+
 struct cs_packet_test : public PACKET_HEADER {
 	int tp;
 	int cp;
@@ -122,6 +139,13 @@ struct cs_packet_test : public PACKET_HEADER {
 //   -> Ŭ Ŷ
 struct sc_packet_unique_no : public PACKET_HEADER {
 	unsigned __int64 unique_no;
+	unsigned __int64 udp_handle;	// UDP datagram    ڵ
+	unsigned __int64 udp_token;		// UDP datagram    
+	int udp_port;					// ̵ Packet UDP Ʈ (0 :  )
+};
+
+struct sc_packet_ping : public PACKET_HEADER {
+	unsigned __int64 server_tick;
 };
 
 struct sc_packet_result : public PACKET_HEADER {
@@ -134,4 +158,9 @@ struct sc_packet_dir : public PACKET_HEADER {
 	Location dir;
 };
 
+struct sc_packet_move : public PACKET_HEADER {
+	unsigned __int64 unique_no;		// ̵ ÷̾
+	Location position;				// ̵  ġ
+};
+
 #endif
\ No newline at end of file
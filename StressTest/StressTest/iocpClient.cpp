@@ -11,6 +11,12 @@ IOCP_Client::IOCP_Client()
 	read_buffer.init(MAX_SOCKBUF);
 	send_buffer.init(MAX_SOCKBUF);
 	mIsWorkerRun = true;
+	udpSocket = INVALID_SOCKET;
+	udpHandle = 0;
+	udpToken = 0;
+	udpSendSeq = 0;
+	udpRecvSeq = 0;
+	udpReady = false;
 }
 
 IOCP_Client::~IOCP_Client()
@@ -83,6 +89,106 @@ bool IOCP_Client::connectServer(const char * ipAddres)
 	return true;
 }
 
+bool IOCP_Client::initUdp(const char * ipAddres, const int port, const unsigned __int64 handle, const unsigned __int64 token)
+{
+	udpSocket = WSASocket(AF_INET, SOCK_DGRAM, IPPROTO_UDP, NULL, NULL, WSA_FLAG_OVERLAPPED);
+	if (INVALID_SOCKET == udpSocket) {
+		spdlog::error("UDP socket() Function failure : {} || [unique_no:{}]", WSAGetLastError(), unique_no);
+		return false;
+	}
+	ZeroMemory(&udpServerAddr, sizeof(SOCKADDR_IN));
+	udpServerAddr.sin_family = AF_INET;
+	udpServerAddr.sin_port = htons(port);
+	udpServerAddr.sin_addr.s_addr = inet_addr(ipAddres);
+	udpHandle = handle;
+	udpToken = token;
+	udpSendSeq = 0;
+	udpRecvSeq = 0;
+
+	// TCP   CompletionPort  ޴´.
+	auto hIOCP = CreateIoCompletionPort((HANDLE)udpSocket, g_hiocp, (ULONG_PTR)(Player), 0);
+	if (NULL == hIOCP || g_hiocp != hIOCP) {
+		spdlog::error("UDP CreateIoCompletionPort() Function failure : {} || [unique_no:{}]", GetLastError(), unique_no);
+		return false;
+	}
+
+	// ù datagram   bind ǹǷ    Ѵ.
+	udpReady = true;
+	return true;
+}
+
+bool IOCP_Client::SendMoveUdp(char * pMsg, int nLen)
+{
+	char datagram[MAX_SOCKBUF];
+	if (!udpReady || nLen + (int)sizeof(UDP_HEADER) > MAX_SOCKBUF) {
+		return false;
+	}
+	UDP_HEADER header;
+	header.handle = udpHandle;
+	header.token = udpToken;
+	header.seq = ++udpSendSeq;
+	header.reserved = 0;
+	memcpy(datagram, &header, sizeof(header));
+	memcpy(datagram + sizeof(header), pMsg, nLen);
+
+	int nRet = sendto(udpSocket, datagram, sizeof(header) + nLen, 0, (sockaddr *)&udpServerAddr, sizeof(udpServerAddr));
+	if (nRet == SOCKET_ERROR) {
+		spdlog::error("UDP sendto() Function failure : {} || [unique_no:{}]", WSAGetLastError(), unique_no);
+		return false;
+	}
+	if (header.seq == 1) {
+		BindUdpRecv();
+	}
+	return true;
+}
+
+bool IOCP_Client::BindUdpRecv()
+{
+	DWORD dwFlag = 0;
+	DWORD dwRecvNumBytes = 0;
+
+	m_stUdpRecvOverlappedEx.m_wsaBuf.len = MAX_SOCKBUF;
+	m_stUdpRecvOverlappedEx.m_wsaBuf.buf = udpRecvBuf;
+	m_stUdpRecvOverlappedEx.m_eOperation = IOOperation::UDP_RECV;
+	m_stUdpRecvOverlappedEx.m_socketSession = udpSocket;
+	udpFromLen = sizeof(udpFromAddr);
+
+	int nRet = WSARecvFrom(udpSocket,
+		&(m_stUdpRecvOverlappedEx.m_wsaBuf),
+		1,
+		&dwRecvNumBytes,
+		&dwFlag,
+		(sockaddr *)&udpFromAddr,
+		&udpFromLen,
+		(LPWSAOVERLAPPED) & (m_stUdpRecvOverlappedEx),
+		NULL);
+
+	if (nRet == SOCKET_ERROR && (WSAGetLastError() != ERROR_IO_PENDING)) {
+		spdlog::error("WSARecvFrom() Function failure : {} || [unique_no:{}]", WSAGetLastError(), unique_no);
+		return false;
+	}
+	return true;
+}
+
+void IOCP_Client::OnUdpRecv(int ioSize)
+{
+	UDP_HEADER header;
+	PACKET_HEADER packetHeader;
+	if (ioSize >= (int)(sizeof(header) + sizeof(packetHeader))) {
+		memcpy(&header, udpRecvBuf, sizeof(header));
+		memcpy(&packetHeader, udpRecvBuf + sizeof(header), sizeof(packetHeader));
+		if (udpRecvSeq != 0 && (int)(header.seq - udpRecvSeq) <= 0) {
+			// ̹  ֱ ̵ ޾Ҵ.
+			moveLatency.onStale();
+		}
+		else if (packetHeader.packet_len == ioSize - (int)sizeof(header)) {
+			udpRecvSeq = header.seq;
+			api.packet_Add(unique_no, udpRecvBuf + sizeof(header), packetHeader.packet_len);
+		}
+	}
+	BindUdpRecv();
+}
+
 void IOCP_Client::destroyThread()
 {
 	mIsWorkerRun = false;
@@ -127,6 +233,7 @@ bool IOCP_Client::BindRecv(PLAYER * pPlayer)
 
 bool IOCP_Client::SendPacket(char * pMsg, int nLen)
 {
+	std::lock_guard<std::mutex> sendGuard(mSendLock);
 	send_buffer.setWriteBuffer(pMsg, nLen);
 
 	m_stSendOverlappedEx.m_wsaBuf.len = send_buffer.getReadAbleSize();
@@ -208,6 +315,12 @@ void IOCP_Client::WokerThread()
 		}
 		break;
 
+		case IOOperation::UDP_RECV:
+		{
+			OnUdpRecv(dwIoSize);
+		}
+		break;
+
 		case IOOperation::SEND:
 		{
 			// Overlapped I/O Send۾   ó
@@ -275,7 +388,29 @@ void IOCP_Client::OnRecv(stOverlappedEx * pOver, int ioSize)
 			// API ̺귯 ش    ش.
 			ProtocolType protocolBase = (ProtocolType)((int)header.packet_type / (int)PACKET_RANG_SIZE * (int)PACKET_RANG_SIZE);
 
-			api.packet_Add(Player->get_unique_no(), read_buffer.getReadBuffer(), header.packet_len);
+			// UDP    Ƿ ⼭ Ѵ.
+			if (header.packet_type == SERVER_AUTH_UNIQUENO && header.packet_len >= sizeof(sc_packet_unique_no)) {
+				sc_packet_unique_no uniquePacket;
+				memcpy(&uniquePacket, read_buffer.getReadBuffer(), sizeof(uniquePacket));
+				set_unique_no(uniquePacket.unique_no);
+				if (uniquePacket.udp_port > 0 && uniquePacket.udp_token != 0 && !udpReady) {
+					initUdp(ipAddres, uniquePacket.udp_port, uniquePacket.udp_handle, uniquePacket.udp_token);
+				}
+			}
+
+			//   ˻ PING    ٷ PONG  . (Api  ѱ ʴ´)
+			if (header.packet_type == SERVER_AUTH_PING && header.packet_len >= sizeof(sc_packet_ping)) {
+				sc_packet_ping pingPacket;
+				memcpy(&pingPacket, read_buffer.getReadBuffer(), sizeof(pingPacket));
+				cs_packet_pong pongPacket;
+				pongPacket.packet_len = sizeof(pongPacket);
+				pongPacket.packet_type = CLIENT_AUTH_PONG;
+				pongPacket.server_tick = pingPacket.server_tick;
+				SendPacket(reinterpret_cast<char *>(&pongPacket), sizeof(pongPacket));
+			}
+			else {
+				api.packet_Add(Player->get_unique_no(), read_buffer.getReadBuffer(), header.packet_len);
+			}
 
 			// б Ϸ ó
 			read_buffer.moveReadPos(header.packet_len);
@@ -6,6 +6,7 @@
 enum class IOOperation {
 	RECV,
 	SEND,
+	UDP_RECV,
 	IO_EVENT,
 	DisconnectRemove
 };
@@ -37,11 +38,14 @@ public:
 	bool SendPacket(char* pMsg, int nLen);							// Packet Send ó Ѵ.
 	bool initClient();
 	bool connectServer(const char * ipAddres);
+	bool initUdp(const char * ipAddres, const int port, const unsigned __int64 handle, const unsigned __int64 token);	// α  UDP  
+	bool SendMoveUdp(char* pMsg, int nLen);						// UDP_HEADER  ٿ ̵ Packet 
 	void destroyThread();
 	
 	// get
 	unsigned __int64 get_unique_no() { return unique_no; }
 	int& get_remainSize() { return remainSize; }
+	bool get_udpReady() { return udpReady; }
 
 	// set
 	void set_unique_no(const unsigned __int64 value) { unique_no = value; }
@@ -56,10 +60,24 @@ private:
 	int errcnt;															// Packet Error Count
 	stOverlappedEx	m_stRecvOverlappedEx;								// RECV Overlapped I/O۾  
 	stOverlappedEx	m_stSendOverlappedEx;								// SEND Overlapped I/O۾  
+	std::mutex mSendLock;												// Main / Worker Thread (PONG)  lock
+	stOverlappedEx	m_stUdpRecvOverlappedEx;							// UDP RECV Overlapped I/O۾  
+	SOCKET udpSocket;													// ̵ Packet UDP 
+	SOCKADDR_IN udpServerAddr;											//  UDP ּ
+	SOCKADDR_IN udpFromAddr;											//  datagram ּ
+	int udpFromLen;
+	char udpRecvBuf[MAX_SOCKBUF];
+	unsigned __int64 udpHandle;											// α   ڵ
+	unsigned __int64 udpToken;											// α   
+	unsigned int udpSendSeq;											//   seq
+	unsigned int udpRecvSeq;											//   seq
+	std::atomic<bool> udpReady;											// UDP   
 
 	bool CreateWokerThread();											// WorkThread init
 	void WokerThread();													// WorkThread
 	void OnRecv(struct stOverlappedEx* pOver, int ioSize);				// Recv ó  Ѵ.
+	bool BindUdpRecv();													// UDP Overlapped  
+	void OnUdpRecv(int ioSize);											// ʰ  ̵  API  ѱ.
 
 };
 
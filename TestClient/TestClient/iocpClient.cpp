@@ -127,6 +127,7 @@ bool IOCP_Client::BindRecv(PLAYER * pPlayer)
 
 bool IOCP_Client::SendPacket(char * pMsg, int nLen)
 {
+	std::lock_guard<std::mutex> sendGuard(mSendLock);
 	send_buffer.setWriteBuffer(pMsg, nLen);
 
 	m_stSendOverlappedEx.m_wsaBuf.len = send_buffer.getReadAbleSize();
@@ -275,7 +276,19 @@ void IOCP_Client::OnRecv(stOverlappedEx * pOver, int ioSize)
 			// API ̺귯 ش    ش.
 			ProtocolType protocolBase = (ProtocolType)((int)header.packet_type / (int)PACKET_RANG_SIZE * (int)PACKET_RANG_SIZE);
 
-			api.packet_Add(Player->get_unique_no(), read_buffer.getReadBuffer(), header.packet_len);
+			//   ˻ PING    ٷ PONG  . (Api  ѱ ʴ´)
+			if (header.packet_type == SERVER_AUTH_PING && header.packet_len >= sizeof(sc_packet_ping)) {
+				sc_packet_ping pingPacket;
+				memcpy(&pingPacket, read_buffer.getReadBuffer(), sizeof(pingPacket));
+				cs_packet_pong pongPacket;
+				pongPacket.packet_len = sizeof(pongPacket);
+				pongPacket.packet_type = CLIENT_AUTH_PONG;
+				pongPacket.server_tick = pingPacket.server_tick;
+				SendPacket(reinterpret_cast<char *>(&pongPacket), sizeof(pongPacket));
+			}
+			else {
+				api.packet_Add(Player->get_unique_no(), read_buffer.getReadBuffer(), header.packet_len);
+			}
 
 			// б Ϸ ó
 			read_buffer.moveReadPos(header.packet_len);
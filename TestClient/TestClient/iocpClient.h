@@ -56,6 +56,7 @@ private:
 	int errcnt;															// Packet Error Count
 	stOverlappedEx	m_stRecvOverlappedEx;								// RECV Overlapped I/O۾  
 	stOverlappedEx	m_stSendOverlappedEx;								// SEND Overlapped I/O۾  
+	std::mutex mSendLock;												// Main / Worker Thread (PONG)  lock
 
 	bool CreateWokerThread();											// WorkThread init
 	void WokerThread();													// WorkThread